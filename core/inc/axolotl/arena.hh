@@ -0,0 +1,87 @@
+#pragma once
+
+#include <axolotl/types.hh>
+#include <cstddef>
+#include <vector>
+
+namespace axl {
+
+  constexpr size_t ARENA_BLOCK_SIZE = 1 << 20;
+
+  // Bump allocator, memory is only given back all at once by Reset(). Blocks added while running are merged into
+  // one on the next Reset(), so once a frame has seen its peak usage the arena stops calling malloc.
+  // Not thread safe.
+  class Arena {
+   public:
+    Arena(size_t block_size = ARENA_BLOCK_SIZE);
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    // Only the most recent allocation is actually released, growing vectors hit this often
+    void Free(void *data, size_t size);
+    void Reset();
+
+    size_t GetUsed() const;
+    size_t GetCapacity() const;
+    // malloc calls since the last Reset()
+    u32 GetSystemAllocations() const;
+
+    // Scratch memory for the main thread, reset when the window finishes a frame
+    static Arena &GetFrameArena();
+
+   protected:
+    class Block {
+     public:
+      u8 *data;
+      size_t size;
+    };
+
+    void AddBlock(size_t min_size);
+
+    std::vector<Block> _blocks;
+    size_t _block_size;
+    size_t _offset;
+    size_t _used;
+    u8 *_last;
+    u32 _system_allocations;
+  };
+
+  // STL allocator drawing from an Arena, defaults to the frame arena
+  template<typename T>
+  class ArenaAllocator {
+   public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept: arena(&Arena::GetFrameArena()) { }
+    ArenaAllocator(Arena &arena) noexcept: arena(&arena) { }
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept: arena(other.arena) { }
+
+    T *allocate(size_t count) {
+      return (T *)arena->Allocate(count * sizeof(T), alignof(T));
+    }
+
+    void deallocate(T *data, size_t count) noexcept {
+      arena->Free(data, count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept {
+      return arena == other.arena;
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const noexcept {
+      return arena != other.arena;
+    }
+
+    Arena *arena;
+  };
+
+  // Must not outlive the frame it was created in
+  template<typename T>
+  using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace axl
@@ -9,6 +9,7 @@ namespace axl {
   class Axolotl {
    public:
     static void Init();
+    static void Terminate();
     static std::string GetDistDir();
   };
 
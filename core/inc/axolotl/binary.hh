@@ -0,0 +1,168 @@
+#pragma once
+
+#include <axolotl/types.hh>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace axl {
+
+  // Little helpers for the binary scene format, values are stored in native byte order.
+  class BinaryWriter {
+   public:
+    std::vector<u8> buffer;
+
+    template<typename T>
+    void Write(const T &value) {
+      static_assert(std::is_trivially_copyable_v<T>, "Type needs a Write overload");
+      WriteBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void Write(const std::vector<T> &values) {
+      Write((u32)values.size());
+      for (const T &value : values)
+        Write(value);
+    }
+
+    void Write(const std::string &value) {
+      Write((u32)value.size());
+      WriteBytes(value.data(), value.size());
+    }
+
+    void Write(const std::filesystem::path &value) {
+      Write(value.generic_string());
+    }
+
+    inline void WriteBytes(const void *data, size_t size) {
+      size_t offset = buffer.size();
+      buffer.resize(offset + size);
+      if (size)
+        std::memcpy(buffer.data() + offset, data, size);
+    }
+
+    // Writes a placeholder and returns its offset, so sizes can be filled in once known
+    template<typename T>
+    size_t Reserve() {
+      size_t offset = buffer.size();
+      Write(T());
+      return offset;
+    }
+
+    template<typename T>
+    void Patch(size_t offset, const T &value) {
+      std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+  };
+
+  // Reads from a buffer it does not own, running past the end zeroes the value and flags the reader as failed.
+  class BinaryReader {
+   public:
+    inline BinaryReader(const u8 *data, size_t size): _data(data), _size(size), _offset(0), _failed(false) { }
+
+    template<typename T>
+    void Read(T &value) {
+      static_assert(std::is_trivially_copyable_v<T>, "Type needs a Read overload");
+      const u8 *bytes = ReadBytes(sizeof(T));
+      if (bytes)
+        std::memcpy(&value, bytes, sizeof(T));
+      else
+        std::memset(&value, 0, sizeof(T));
+    }
+
+    template<typename T>
+    void Read(std::vector<T> &values) {
+      u32 count = 0;
+      Read(count);
+      // Every element takes at least a byte, a larger count can only come from a corrupt file
+      if (count > _size - _offset) {
+        _failed = true;
+        count = 0;
+      }
+
+      values.resize(count);
+      for (T &value : values)
+        Read(value);
+    }
+
+    void Read(std::string &value) {
+      u32 size = 0;
+      Read(size);
+      const u8 *bytes = ReadBytes(size);
+      if (bytes)
+        value.assign((const char *)bytes, size);
+      else
+        value.clear();
+    }
+
+    void Read(std::filesystem::path &value) {
+      std::string path;
+      Read(path);
+      value = path;
+    }
+
+    inline const u8 *ReadBytes(size_t size) {
+      if (_failed || size > _size - _offset) {
+        _failed = true;
+        return nullptr;
+      }
+
+      const u8 *bytes = _data + _offset;
+      _offset += size;
+      return bytes;
+    }
+
+    inline void Seek(size_t offset) {
+      if (offset > _size)
+        _failed = true;
+      else
+        _offset = offset;
+    }
+
+    inline size_t Tell() const {
+      return _offset;
+    }
+
+    inline bool Failed() const {
+      return _failed;
+    }
+
+   protected:
+    const u8 *_data;
+    size_t _size;
+    size_t _offset;
+    bool _failed;
+  };
+
+  // Read only memory mapping of a whole file
+  class MappedFile {
+   public:
+    MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    inline const u8 *GetData() const {
+      return _data;
+    }
+
+    inline size_t GetSize() const {
+      return _size;
+    }
+
+    inline operator bool() const {
+      return _data != nullptr;
+    }
+
+   protected:
+    const u8 *_data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+  };
+
+} // namespace axl
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <axolotl/arena.hh>
+#include <axolotl/types.hh>
+#include <entt/entt.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace axl {
+
+  constexpr i32 BROADPHASE_NULL_NODE = -1;
+  // Fattening applied to every proxy, bodies can move this much before the tree is touched
+  constexpr f32 BROADPHASE_MARGIN = 0.1f;
+  // Rays traversed together, one bit each in the traversal masks
+  constexpr u32 BROADPHASE_RAY_PACKET_SIZE = 32;
+
+  // Query layers, a proxy can be on several of them
+  constexpr u32 PHYSICS_LAYER_DEFAULT = 1 << 0;
+  constexpr u32 PHYSICS_LAYER_ALL = ~0u;
+
+  class BroadphaseNode {
+   public:
+    // Fat bounds for internal and leaf nodes
+    v3 min;
+    v3 max;
+    // Tight bounds, only meaningful for leaves
+    v3 bounds_min;
+    v3 bounds_max;
+
+    entt::entity entity;
+    u32 layers;
+    i32 parent;
+    i32 left;
+    i32 right;
+    i32 height;
+    u32 stamp;
+
+    inline bool IsLeaf() const {
+      return left == BROADPHASE_NULL_NODE;
+    }
+  };
+
+  class BroadphasePair {
+   public:
+    entt::entity a;
+    entt::entity b;
+  };
+
+  // Rays laid out as lanes for the SIMD slab tests. Directions are stored inverted, a ray whose max distance drops
+  // below zero no longer hits anything.
+  class RayPacket {
+   public:
+    alignas(32) f32 origin[3][BROADPHASE_RAY_PACKET_SIZE];
+    alignas(32) f32 inv_direction[3][BROADPHASE_RAY_PACKET_SIZE];
+    alignas(32) f32 max_distance[BROADPHASE_RAY_PACKET_SIZE];
+    u32 count = 0;
+
+    void Set(u32 index, const v3 &origin, const v3 &direction, f32 max_distance);
+  };
+
+  // Dynamic AABB tree over the collider bounds of every rigid body, rebalanced on insertion.
+  // Proxies are refreshed between Begin() and End(), anything not refreshed is dropped.
+  class Broadphase {
+   public:
+    Broadphase();
+
+    void Begin();
+    void Update(entt::entity entity, const v3 &min, const v3 &max, u32 layers = PHYSICS_LAYER_DEFAULT);
+    void End();
+    void Clear();
+
+    void QueryPairs(FrameVector<BroadphasePair> &pairs) const;
+    u32 GetProxyCount() const;
+
+    inline static bool Overlaps(const v3 &a_min, const v3 &a_max, const v3 &b_min, const v3 &b_max) {
+      return (a_min.x <= b_max.x && a_max.x >= b_min.x) && (a_min.y <= b_max.y && a_max.y >= b_min.y) &&
+             (a_min.z <= b_max.z && a_max.z >= b_min.z);
+    }
+
+    // Calls callback(node_index) for every leaf whose fat bounds overlap [min, max].
+    // Returning false from the callback stops the traversal.
+    template<typename Callback>
+    void Query(const v3 &min, const v3 &max, Callback callback) const {
+      if (_root == BROADPHASE_NULL_NODE)
+        return;
+
+      std::array<i32, 256> stack;
+      i32 count = 0;
+      stack[count++] = _root;
+
+      while (count > 0) {
+        i32 index = stack[--count];
+        const BroadphaseNode &node = _nodes[index];
+        if (!Overlaps(node.min, node.max, min, max))
+          continue;
+
+        if (node.IsLeaf()) {
+          if (!callback(index))
+            return;
+          continue;
+        }
+
+        AXL_ASSERT_MESSAGE(count + 2 <= (i32)stack.size(), "Broadphase tree is too deep");
+        stack[count++] = node.left;
+        stack[count++] = node.right;
+      }
+    }
+
+    // Bit i is set when ray i of the packet crosses the fat bounds of the node within its max distance
+    u32 RayMask(const RayPacket &packet, const BroadphaseNode &node, u32 active) const;
+
+    // Walks the tree once for the whole packet, calling callback(ray, node_index) for every leaf a ray crosses.
+    // Subtrees are skipped as soon as no ray of the packet reaches them, the callback can shrink the max distance
+    // of a ray to prune what is left for it.
+    template<typename Callback>
+    void QueryRays(RayPacket &packet, Callback callback) const {
+      if (_root == BROADPHASE_NULL_NODE || packet.count == 0)
+        return;
+
+      std::array<i32, 256> stack;
+      std::array<u32, 256> stack_masks;
+      i32 count = 0;
+      stack[count] = _root;
+      stack_masks[count++] = packet.count == BROADPHASE_RAY_PACKET_SIZE ? ~0u : (1u << packet.count) - 1;
+
+      while (count > 0) {
+        --count;
+        const BroadphaseNode &node = _nodes[stack[count]];
+        u32 mask = RayMask(packet, node, stack_masks[count]);
+        if (!mask)
+          continue;
+
+        if (node.IsLeaf()) {
+          for (u32 ray = 0; ray < packet.count; ++ray)
+            if (mask & (1u << ray))
+              callback(ray, stack[count]);
+          continue;
+        }
+
+        AXL_ASSERT_MESSAGE(count + 2 <= (i32)stack.size(), "Broadphase tree is too deep");
+        i32 index = stack[count];
+        stack[count] = _nodes[index].left;
+        stack_masks[count++] = mask;
+        stack[count] = _nodes[index].right;
+        stack_masks[count++] = mask;
+      }
+    }
+
+    inline const BroadphaseNode &GetNode(i32 index) const {
+      return _nodes[index];
+    }
+
+   protected:
+    i32 AllocateNode();
+    void FreeNode(i32 index);
+    void InsertLeaf(i32 leaf);
+    void RemoveLeaf(i32 leaf);
+    i32 Balance(i32 index);
+    void Refit(i32 index);
+
+    std::vector<BroadphaseNode> _nodes;
+    std::unordered_map<entt::entity, i32> _proxies;
+    i32 _root;
+    i32 _free_list;
+    u32 _stamp;
+  };
+
+} // namespace axl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <axolotl/light.hh>
+#include <axolotl/types.hh>
+#include <vector>
+
+namespace axl {
+
+  // Point lights binned into the CLUSTER_GRID_X * Y * Z clusters of the view frustum, so a fragment only shades the
+  // lights reaching its own cluster. Clusters are indexed x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z), each range
+  // is an offset and a count into the flat list of light indices.
+  class LightClusters {
+   public:
+    LightClusters();
+
+    void Build(const m4 &view, const m4 &projection, const LightData *lights, u32 count);
+
+    // x = near, y = far, z = scale, w = bias, slice = log(depth) * scale + bias
+    const v4 &GetDepthParameters() const;
+    const std::vector<v2u> &GetRanges() const;
+    const std::vector<u32> &GetIndices() const;
+
+   protected:
+    i32 Slice(f32 depth) const;
+
+    v4 _depth_parameters;
+    std::vector<v2u> _ranges;
+    std::vector<u32> _indices;
+    // Inclusive cluster bounds of every light, lights reaching no cluster have min above max
+    std::vector<v3i> _light_min;
+    std::vector<v3i> _light_max;
+  };
+
+} // namespace axl
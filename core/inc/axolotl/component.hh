@@ -1,5 +1,6 @@
 #pragma once
 
+#include <axolotl/binary.hh>
 #include <axolotl/types.hh>
 #include <entt/entt.hpp>
 #include <imgui.h>
@@ -97,10 +98,21 @@
     .func<&Type::GetHash>("GetHash"_hs)                                                                            \
     .func<&Type::Init>("Init"_hs) COMPONENT_FOR_EACH(REGISTER_COMPONENT_MEMBER, Type, __VA_ARGS__)
 
-#define REGISTER_COMPONENT_DATA_TYPE(Type) \
-  entt::meta<Type>().type().conv<json>().func<&DefaultFromJson<Type>>("FromJSON"_hs)
+#define REGISTER_COMPONENT_DATA_TYPE(Type)       \
+  entt::meta<Type>()                             \
+    .type()                                      \
+    .conv<json>()                                \
+    .func<&DefaultFromJson<Type>>("FromJSON"_hs) \
+    .func<&DefaultToBinary<Type>>("ToBinary"_hs) \
+    .func<&DefaultFromBinary<Type>>("FromBinary"_hs)
 #define REGISTER_COMPONENT_DATA_TYPE_CTOR(Type, ...) \
-  entt::meta<Type>().type().ctor<__VA_ARGS__>().conv<json>().func<&DefaultFromJson<Type>>("FromJSON"_hs)
+  entt::meta<Type>()                                 \
+    .type()                                          \
+    .ctor<__VA_ARGS__>()                             \
+    .conv<json>()                                    \
+    .func<&DefaultFromJson<Type>>("FromJSON"_hs)     \
+    .func<&DefaultToBinary<Type>>("ToBinary"_hs)     \
+    .func<&DefaultFromBinary<Type>>("FromBinary"_hs)
 
 #define REGISTER_COMPONENT(Type, ...)                \
   static i32 RegisterComponent() {                   \
@@ -126,6 +138,16 @@ namespace axl {
     t = j.get<T>();
   }
 
+  template<typename T>
+  static void DefaultToBinary(BinaryWriter &writer, const T &t) {
+    writer.Write(t);
+  }
+
+  template<typename T>
+  static void DefaultFromBinary(BinaryReader &reader, T &t) {
+    reader.Read(t);
+  }
+
   template<typename T>
   class MetaHolder {
    public:
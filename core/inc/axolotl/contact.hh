@@ -0,0 +1,110 @@
+#pragma once
+
+#include <axolotl/fixedvector.hh>
+#include <axolotl/types.hh>
+#include <entt/entt.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace axl {
+
+  class CollisionManifold;
+  class RigidBody;
+
+  // Cached points closer than this to a point of the previous step inherit its impulses
+  constexpr f32 CONTACT_MATCH_DISTANCE = 0.05f;
+  // Box-box manifolds are reduced to this many points, enough to keep a resting box stable
+  constexpr u32 MANIFOLD_MAX_POINTS = 4;
+
+  class ContactPoint {
+   public:
+    v3 position;
+    v3 r_a;
+    v3 r_b;
+    f64 normal_mass;
+    f64 tangent_mass[2];
+    f64 velocity_bias;
+
+    // Accumulated over the solver iterations and carried to the next step for warm starting
+    f64 normal_impulse;
+    f64 tangent_impulse[2];
+
+    inline ContactPoint():
+      position(0.0f),
+      r_a(0.0f),
+      r_b(0.0f),
+      normal_mass(0.0),
+      tangent_mass { 0.0, 0.0 },
+      velocity_bias(0.0),
+      normal_impulse(0.0),
+      tangent_impulse { 0.0, 0.0 } { }
+  };
+
+  class ContactConstraint {
+   public:
+    entt::entity a;
+    entt::entity b;
+    v3 normal;
+    v3 tangents[2];
+    f64 depth;
+    f64 friction;
+    f64 inv_mass_a;
+    f64 inv_mass_b;
+    m3 inv_tensor_a;
+    m3 inv_tensor_b;
+    FixedVector<ContactPoint, MANIFOLD_MAX_POINTS> points;
+    u32 stamp;
+
+    // Builds the constraint for this step, points that survived from the last step keep their impulses
+    void Prepare(const CollisionManifold &manifold,
+                 const RigidBody &body_a,
+                 const RigidBody &body_b,
+                 const v3 &position_a,
+                 const v3 &position_b);
+  };
+
+  // Full handles of both entities, versions included, so a recycled entity never picks up a stale contact
+  class ContactKey {
+   public:
+    entt::entity a;
+    entt::entity b;
+
+    inline bool operator==(const ContactKey &other) const {
+      return a == other.a && b == other.b;
+    }
+  };
+
+  class ContactKeyHash {
+   public:
+    inline size_t operator()(const ContactKey &key) const {
+      u64 a = (u64)entt::to_integral(key.a);
+      u64 b = (u64)entt::to_integral(key.b);
+      // boost::hash_combine, widened to 64 bits
+      return (size_t)(a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2)));
+    }
+  };
+
+  // Contacts keyed by the ordered entity pair that produced them, kept alive while the pair keeps touching.
+  class ContactCache {
+   public:
+    void Begin();
+    // Returns the constraint for the pair, creating it if the pair was not touching on the last step.
+    ContactConstraint &Get(entt::entity a, entt::entity b);
+    // Keeps the contact of a sleeping pair alive without handing it to the solver, nullptr if the pair was not
+    // touching.
+    ContactConstraint *Keep(entt::entity a, entt::entity b);
+    void End();
+    void Clear();
+
+    std::vector<ContactConstraint *> &GetActive();
+    std::vector<ContactConstraint *> &GetSleeping();
+    u32 GetCount() const;
+
+   protected:
+    std::unordered_map<ContactKey, ContactConstraint, ContactKeyHash> _contacts;
+    std::vector<ContactConstraint *> _active;
+    std::vector<ContactConstraint *> _sleeping;
+    u32 _stamp = 0;
+  };
+
+} // namespace axl
@@ -102,7 +102,7 @@ namespace axl {
       if (!scene)
         return Ento();
       entt::entity e = entt::to_entity(scene->GetRegistry(), component);
-      return _handle_ento_map[e];
+      return scene->FromHandle(e);
     }
 
     operator bool() const {
@@ -146,13 +146,10 @@ namespace axl {
    protected:
     friend class Scene;
 
-    static void ClearMaps();
     static uuids::uuid_random_generator _uuid_generator;
     inline static std::mt19937 _random_generator;
 
     inline static bool _first_gen = true;
-    inline static std::map<uuid, Ento> _uuid_ento_map;
-    inline static std::map<entt::entity, Ento> _handle_ento_map;
   };
 
 } // namespace axl
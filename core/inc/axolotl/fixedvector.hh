@@ -0,0 +1,81 @@
+#pragma once
+
+#include <axolotl/types.hh>
+
+namespace axl {
+
+  // Vector with inline storage for at most Capacity elements, never allocates
+  template<typename T, u32 Capacity>
+  class FixedVector {
+   public:
+    inline void push_back(const T &value) {
+      AXL_ASSERT_MESSAGE(_size < Capacity, "FixedVector is full");
+      _data[_size++] = value;
+    }
+
+    inline void pop_back() {
+      _size--;
+    }
+
+    // Moves the last element into the hole, order is not kept
+    inline void erase_unordered(u32 index) {
+      _data[index] = _data[--_size];
+    }
+
+    inline void resize(u32 size) {
+      AXL_ASSERT_MESSAGE(size <= Capacity, "FixedVector is full");
+      for (u32 i = _size; i < size; ++i)
+        _data[i] = T();
+      _size = size;
+    }
+
+    inline void clear() {
+      _size = 0;
+    }
+
+    inline bool full() const {
+      return _size == Capacity;
+    }
+
+    inline bool empty() const {
+      return _size == 0;
+    }
+
+    inline u32 size() const {
+      return _size;
+    }
+
+    static constexpr u32 capacity() {
+      return Capacity;
+    }
+
+    inline T &operator[](u32 index) {
+      return _data[index];
+    }
+
+    inline const T &operator[](u32 index) const {
+      return _data[index];
+    }
+
+    inline T *begin() {
+      return _data;
+    }
+
+    inline T *end() {
+      return _data + _size;
+    }
+
+    inline const T *begin() const {
+      return _data;
+    }
+
+    inline const T *end() const {
+      return _data + _size;
+    }
+
+   protected:
+    T _data[Capacity];
+    u32 _size = 0;
+  };
+
+} // namespace axl
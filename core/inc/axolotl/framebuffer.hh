@@ -14,6 +14,7 @@ namespace axl {
 
     void RebuildFrameBuffer();
     void SetSize(u32 width, u32 height);
+    v2u GetSize() const;
     void Bind();
     void Unbind();
     Texture2D GetTexture(FrameBufferTexture texture);
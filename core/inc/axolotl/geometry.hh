@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <axolotl/component.hh>
+#include <axolotl/contact.hh>
 #include <axolotl/ento.hh>
+#include <axolotl/fixedvector.hh>
 #include <axolotl/types.hh>
 
 namespace axl {
@@ -71,6 +74,7 @@ namespace axl {
     bool PlaneInside(const Plane &plane) const;
     f64 RayInside(const Ray &ray) const;
     v3 ClosestPoint(const v3 &point) const;
+    AABBCollider GetBounds() const;
 
     CollisionManifold SphereCollide(const SphereCollider &sphere) const;
     CollisionManifold OBBCollide(const OBBCollider &obb) const;
@@ -102,24 +106,11 @@ namespace axl {
       return v3(max(p0.x, p1.x), max(p0.y, p1.y), max(p0.z, p1.z));
     }
 
+    // Projected center plus the projected extents, the same interval as projecting all 8 vertices
     inline Interval GetInterval(const v3 &axis) const {
-      v3 min = GetMin();
-      v3 max = GetMax();
-
-      v3 vertex[8] = { { min.x, max.y, max.z }, { min.x, max.y, min.z }, { min.x, min.y, max.z },
-                       { min.x, min.y, min.z }, { max.x, max.y, max.z }, { max.x, max.y, min.z },
-                       { max.x, min.y, max.z }, { max.x, min.y, min.z } };
-
-      Interval result;
-      result.min = result.max = dot(axis, vertex[0]);
-
-      for (i32 i = 1; i < 8; ++i) {
-        f64 projection = dot(axis, vertex[i]);
-        result.min = (projection < result.min) ? projection : result.min;
-        result.max = (projection > result.max) ? projection : result.max;
-      }
-
-      return result;
+      f64 center = dot(axis, position);
+      f64 radius = dot(abs(axis), abs(size));
+      return Interval(center - radius, center + radius);
     }
 
     static inline AABBCollider FromMinMax(const v3 &min, const v3 &max) {
@@ -158,37 +149,10 @@ namespace axl {
     }
 
     inline Interval GetInterval(const v3 &axis) const {
-      v3 vertex[8];
-      v3 center = position;
-      v3 extents = size;
-
-      vertex[0] =
-        center + rotation_matrix[0] * extents[0] + rotation_matrix[1] * extents[1] + rotation_matrix[2] * extents[2];
-      vertex[1] =
-        center - rotation_matrix[0] * extents[0] + rotation_matrix[1] * extents[1] + rotation_matrix[2] * extents[2];
-      vertex[2] =
-        center + rotation_matrix[0] * extents[0] - rotation_matrix[1] * extents[1] + rotation_matrix[2] * extents[2];
-      vertex[3] =
-        center + rotation_matrix[0] * extents[0] + rotation_matrix[1] * extents[1] - rotation_matrix[2] * extents[2];
-      vertex[4] =
-        center - rotation_matrix[0] * extents[0] - rotation_matrix[1] * extents[1] - rotation_matrix[2] * extents[2];
-      vertex[5] =
-        center + rotation_matrix[0] * extents[0] - rotation_matrix[1] * extents[1] - rotation_matrix[2] * extents[2];
-      vertex[6] =
-        center - rotation_matrix[0] * extents[0] + rotation_matrix[1] * extents[1] - rotation_matrix[2] * extents[2];
-      vertex[7] =
-        center - rotation_matrix[0] * extents[0] - rotation_matrix[1] * extents[1] + rotation_matrix[2] * extents[2];
-
-      Interval result;
-      result.min = result.max = dot(axis, vertex[0]);
-
-      for (i32 i = 1; i < 8; ++i) {
-        f64 projection = dot(axis, vertex[i]);
-        result.min = (projection < result.min) ? projection : result.min;
-        result.max = (projection > result.max) ? projection : result.max;
-      }
-
-      return result;
+      f64 center = dot(axis, position);
+      v3 projected(dot(axis, rotation_matrix[0]), dot(axis, rotation_matrix[1]), dot(axis, rotation_matrix[2]));
+      f64 radius = dot(abs(projected), abs(size));
+      return Interval(center - radius, center + radius);
     }
 
     void Init() { }
@@ -201,16 +165,12 @@ namespace axl {
     bool PlaneInside(const Plane &plane) const;
     f64 RayInside(const Ray &ray) const;
     v3 ClosestPoint(const v3 &point) const;
+    AABBCollider GetBounds() const;
 
     CollisionManifold SphereCollide(const SphereCollider &sphere) const;
     CollisionManifold OBBCollide(const OBBCollider &obb) const;
 
-    std::vector<v3> ClipEdgesToOBB(const std::vector<Line> &edges) const;
-    std::vector<v3> GetVertices() const;
-    std::vector<Line> GetEdges() const;
-    std::vector<Plane> GetPlanes() const;
-    bool ClipToPlane(const Plane &plane, const Line &line, v3 &out_point) const;
-    f64 PenetrationDepth(const OBBCollider &obb, const v3 &axis, bool &out_should_flip) const;
+    std::array<v3, 8> GetVertices() const;
 
     bool ShowComponent();
 
@@ -239,22 +199,30 @@ namespace axl {
     v3 ClosestPoint(const v3 &point) const;
   };
 
+  // Six inward facing planes, a point is inside when it is in front of all of them
+  class Frustum {
+   public:
+    std::array<Plane, 6> planes;
+
+    // Extracts the planes from a projection * view matrix, so they are in world space
+    static Frustum FromMatrix(const m4 &view_projection);
+
+    // Conservative, boxes near the corners can pass while being outside
+    bool AABBInside(const AABBCollider &aabb) const;
+  };
+
   class CollisionManifold {
    public:
     bool colliding;
     v3 normal;
     f64 depth;
-    std::vector<v3> points;
+    FixedVector<v3, MANIFOLD_MAX_POINTS> points;
 
     inline CollisionManifold() {
       Reset();
     }
 
-    inline CollisionManifold(const v3 &normal, f32 depth, const std::vector<v3> &points):
-      colliding(false),
-      normal(normal),
-      depth(depth),
-      points(points) { }
+    inline CollisionManifold(const v3 &normal, f32 depth): colliding(false), normal(normal), depth(depth) { }
 
     void Reset();
   };
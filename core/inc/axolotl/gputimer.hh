@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <axolotl/types.hh>
+#include <string>
+#include <vector>
+
+namespace axl {
+
+  // Frames a query is given to finish before its result is read, the ring holds this many frames of queries
+  constexpr u32 GPU_TIMER_FRAMES = 4;
+  constexpr u32 GPU_TIMER_MAX_SCOPES = 16;
+
+  // Timestamp queries recycled from a ring, results are read GPU_TIMER_FRAMES - 1 frames later without
+  // waiting on the GPU. Scopes can nest, the frame itself is always the first one.
+  class GPUTimer {
+   public:
+    class Scope {
+     public:
+      std::string name;
+      f64 time; // ms
+    };
+
+    GPUTimer();
+    ~GPUTimer();
+
+    void BeginFrame();
+    void EndFrame();
+    void Begin(const std::string &name);
+    void End();
+
+    // Results of the most recent frame that finished on the GPU
+    f64 GetFrameTime() const;
+    const std::vector<Scope> &GetScopes() const;
+
+   protected:
+    class Frame {
+     public:
+      std::array<u32, GPU_TIMER_MAX_SCOPES * 2> queries;
+      std::array<std::string, GPU_TIMER_MAX_SCOPES> names;
+      u32 scope_count = 0;
+      bool pending = false;
+    };
+
+    void Resolve(Frame &frame);
+
+    std::array<Frame, GPU_TIMER_FRAMES> _frames;
+    std::vector<u32> _open_scopes;
+    std::vector<Scope> _scopes;
+    f64 _frame_time = 0.0;
+    u64 _frame_index = 0;
+  };
+
+} // namespace axl
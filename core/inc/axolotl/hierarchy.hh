@@ -0,0 +1,33 @@
+#pragma once
+
+#include <axolotl/types.hh>
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace axl {
+
+  class UUIDMap;
+
+  // Flattened view of the transform hierarchy, parents always come before their children.
+  // Update() walks it once and recomputes the model matrix of every dirty transform and everything below it.
+  class TransformHierarchy {
+   public:
+    // Has to be called whenever entities are created, removed or reparented
+    void Invalidate();
+    void Update(entt::registry &registry, const UUIDMap &ids);
+
+    u32 GetUpdatedCount() const;
+
+   protected:
+    void Rebuild(entt::registry &registry, const UUIDMap &ids);
+
+    std::vector<entt::entity> _entities;
+    std::vector<i32> _parents;
+    std::vector<m4> _world;
+    std::vector<u8> _dirty;
+
+    bool _invalid = true;
+    u32 _updated_count = 0;
+  };
+
+} // namespace axl
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <axolotl/types.hh>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace axl {
+
+  // Fixed pool of worker threads. The thread calling ParallelFor takes part in the work and is always thread 0.
+  class JobSystem {
+   public:
+    using Job = std::function<void(u32 begin, u32 end, u32 thread_index)>;
+
+    // thread_count includes the calling thread, 0 uses every hardware thread
+    static void Init(u32 thread_count = 0);
+    static void Terminate();
+
+    // Splits [0, count) into chunks of chunk_size and blocks until job ran on all of them.
+    // Not reentrant, jobs must not call ParallelFor themselves.
+    static void ParallelFor(u32 count, u32 chunk_size, const Job &job);
+    static u32 GetThreadCount();
+
+   protected:
+    static void WorkerLoop(u32 thread_index);
+    static void RunChunks(u32 thread_index);
+
+    inline static std::vector<std::thread> _workers;
+    inline static std::mutex _mutex;
+    inline static std::condition_variable _wake;
+    inline static std::condition_variable _done;
+
+    inline static const Job *_job = nullptr;
+    inline static u32 _count = 0;
+    inline static u32 _chunk_size = 1;
+    inline static u32 _chunk_count = 0;
+    inline static std::atomic<u32> _next_chunk = 0;
+    inline static std::atomic<u32> _remaining_chunks = 0;
+    inline static u32 _busy_workers = 0;
+    inline static u64 _generation = 0;
+    inline static bool _running = false;
+  };
+
+} // namespace axl
@@ -5,7 +5,11 @@
 
 namespace axl {
 
-  constexpr u32 LIGHT_COUNT = 32;
+  // Clusters the view frustum is split into, depth slices grow exponentially from the near plane
+  constexpr u32 CLUSTER_GRID_X = 16;
+  constexpr u32 CLUSTER_GRID_Y = 9;
+  constexpr u32 CLUSTER_GRID_Z = 24;
+  constexpr u32 CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
 
   enum class LightType { Ambient, Directional, Point, Spot, Last };
 
@@ -21,11 +25,13 @@ namespace axl {
 
     bool ShowComponent();
 
-    REGISTER_COMPONENT(Light, color, intensity, type)
+    REGISTER_COMPONENT(Light, color, intensity, type, range)
 
     Color color;
     f32 intensity;
     LightType type;
+    // Distance at which point lights fade out completely
+    f32 range;
   };
 
   class LightData {
@@ -33,7 +39,8 @@ namespace axl {
     v4 position;
     v4 color;
     f32 intensity;
-    v3 offset3 = v3(0.0f);
+    f32 range = 0.0f;
+    v2 offset2 = v2(0.0f);
   };
 
 } // namespace axl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <axolotl/types.hh>
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace axl {
+
+  // Dense handle -> uuid table indexed by the entity part of the handle, the stored handle rejects stale versions.
+  class HandleIndex {
+   public:
+    void Insert(entt::entity handle, const uuid &id);
+    void Erase(entt::entity handle);
+    void Clear();
+
+    inline const uuid *Find(entt::entity handle) const {
+      if (handle == entt::null)
+        return nullptr;
+
+      auto index = entt::to_entity(handle);
+      if (index >= _slots.size() || _slots[index].handle != handle)
+        return nullptr;
+      return &_slots[index].id;
+    }
+
+   protected:
+    class Slot {
+     public:
+      entt::entity handle = entt::null;
+      uuid id;
+    };
+
+    std::vector<Slot> _slots;
+  };
+
+  // Open addressing uuid -> handle map with linear probing and backward shift deletion, the nil uuid marks empty slots.
+  class UUIDMap {
+   public:
+    void Insert(const uuid &id, entt::entity handle);
+    void Erase(const uuid &id);
+    void Clear();
+    u32 Size() const;
+
+    entt::entity Find(const uuid &id) const;
+
+   protected:
+    class Slot {
+     public:
+      uuid id;
+      entt::entity handle = entt::null;
+    };
+
+    static u64 Hash(const uuid &id);
+    void Grow();
+
+    std::vector<Slot> _slots;
+    u32 _size = 0;
+  };
+
+} // namespace axl
@@ -21,12 +21,17 @@ namespace axl {
 
     bool Bind(u32 unit = 0, TextureType type = TextureType::Last);
     void BindAll();
+    void BindTextures();
     void Build();
     void AddTexture(const std::filesystem::path &path, TextureType type = TextureType::Last);
     void AddTexture(u32 id, TextureType type = TextureType::Last);
     Shader &GetShader();
+    u32 GetSortID() const;
 
    protected:
+    inline static u32 _sort_id_counter = 0;
+
+    u32 _sort_id;
     std::shared_ptr<Shader> _shader;
     std::array<Texture2D, (i32)TextureType::Last> _textures;
     std::set<std::filesystem::path> _textures_path;
@@ -19,6 +19,8 @@ namespace axl {
     ~Mesh();
 
     void Draw();
+    // Draws count instances with a base instance of first, shaders index their per object data with it
+    void DrawInstanced(u32 first, u32 count);
     void SetMaterialID(u32 id);
     u32 GetMaterialID() const;
 
@@ -42,6 +44,11 @@ namespace axl {
     bool _single_mesh;
     std::vector<BufferData> _buffers;
 
+    // Local space bounds of the vertices, only known for meshes loaded through a Model
+    bool _has_bounds;
+    v3 _bounds_min;
+    v3 _bounds_max;
+
     void LoadBuffers(const std::vector<f32> &vertices, const std::vector<u32> &indices);
   };
 
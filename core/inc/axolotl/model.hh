@@ -32,7 +32,15 @@ namespace axl {
     friend class Renderer;
     friend class Scene;
 
-    static void ProcessNode(Ento ento, Model &model, aiNode *node, const aiScene *scene);
+    // Meshes and materials of every loaded node, so entities using the same file share them and can be instanced
+    class SharedNode {
+     public:
+      std::weak_ptr<std::vector<Mesh *>> meshes;
+      std::weak_ptr<std::unordered_map<u32, std::unique_ptr<Material>>> materials;
+    };
+    inline static std::unordered_map<std::string, SharedNode> _shared_nodes;
+
+    static void ProcessNode(Ento ento, Model &model, aiNode *node, const aiScene *scene, const std::string &node_key);
     static Mesh *ProcessMesh(Ento ento, Model &model, aiMesh *mesh, const aiScene *scene);
     static void ProcessMaterialTextures(u32 index, Model &model, aiMaterial *material, aiTextureType type);
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <axolotl/geometry.hh>
+#include <axolotl/types.hh>
+
+namespace axl {
+
+  // Shapes per packet, one AVX register or two SSE ones
+  constexpr u32 GEOMETRY_PACKET_SIZE = 8;
+
+  // Structure of arrays copy of up to GEOMETRY_PACKET_SIZE boxes, so a single shape is tested against all of them at
+  // once. Queries return a mask with bit i set when shape i is hit, lanes past count never are.
+  class AABBPacket {
+   public:
+    alignas(32) f32 min[3][GEOMETRY_PACKET_SIZE];
+    alignas(32) f32 max[3][GEOMETRY_PACKET_SIZE];
+    u32 count = 0;
+
+    AABBPacket();
+    void Set(u32 index, const AABBCollider &aabb);
+
+    // Same results as AABBCollider::AABBInside
+    u32 AABBInside(const AABBCollider &aabb) const;
+    // Same results as Ray::AABBInside, out_distances gets -1 for every box that is missed
+    u32 RayInside(const Ray &ray, f32 *out_distances) const;
+  };
+
+  class SpherePacket {
+   public:
+    alignas(32) f32 position[3][GEOMETRY_PACKET_SIZE];
+    alignas(32) f32 radius[GEOMETRY_PACKET_SIZE];
+    u32 count = 0;
+
+    SpherePacket();
+    void Set(u32 index, const SphereCollider &sphere);
+
+    // Same results as SphereCollider::SphereInside
+    u32 SphereInside(const SphereCollider &sphere) const;
+    // Same results as Ray::SphereInside, out_distances gets -1 for every sphere that is missed
+    u32 RayInside(const Ray &ray, f32 *out_distances) const;
+  };
+
+} // namespace axl
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <axolotl/broadphase.hh>
 #include <axolotl/component.hh>
+#include <axolotl/contact.hh>
 #include <axolotl/geometry.hh>
 #include <axolotl/types.hh>
 #include <vector>
@@ -9,11 +11,59 @@ namespace axl {
 
   class Scene;
 
+  enum class RaycastMode {
+    Closest,
+    // First hit found, cheaper when only the visibility matters
+    Any
+  };
+
+  class RaycastHit {
+   public:
+    entt::entity entity = entt::null;
+    f32 distance = -1.0f;
+    v3 point = v3(0.0f);
+
+    inline operator bool() const {
+      return entity != entt::null;
+    }
+  };
+
   class Physics {
    public:
     static void Step(Scene &scene, f64 step);
+    static CollisionManifold Collide(const entt::registry &registry, entt::entity a, entt::entity b);
+
+    // Rays are tested against the colliders of the rigid bodies on any of the layers in mask, as of the last step.
+    // Origins inside a collider hit it where the ray leaves it.
+    static RaycastHit Raycast(Scene &scene,
+                              const Ray &ray,
+                              RaycastMode mode = RaycastMode::Closest,
+                              u32 mask = PHYSICS_LAYER_ALL,
+                              entt::entity ignore = entt::null,
+                              f32 max_distance = std::numeric_limits<f32>::max());
+    // Rays are walked down the broadphase tree in packets, out_hits needs room for count hits
+    static void RaycastBatch(Scene &scene,
+                             const Ray *rays,
+                             u32 count,
+                             RaycastHit *out_hits,
+                             RaycastMode mode = RaycastMode::Closest,
+                             u32 mask = PHYSICS_LAYER_ALL,
+                             entt::entity ignore = entt::null,
+                             f32 max_distance = std::numeric_limits<f32>::max());
 
     inline static f64 total_physics_time = 0.0;
+    inline static u32 broadphase_pair_count = 0;
+    inline static u32 broadphase_proxy_count = 0;
+    inline static u32 contact_count = 0;
+    inline static u32 solver_iteration_count = 0;
+    inline static u32 sleeping_body_count = 0;
+    inline static u32 continuous_hit_count = 0;
+
+   protected:
+    // Groups dynamic bodies connected by contacts, an island sleeps once all of its bodies have rested long enough
+    // and wakes as a whole when any of them is disturbed
+    static void UpdateIslands(entt::registry &registry, ContactCache &contacts, f64 step);
+    static entt::entity FindIsland(entt::registry &registry, entt::entity entity);
   };
 
   class RigidBody {
@@ -52,19 +102,43 @@ namespace axl {
       is_trigger(false) { }
 
     f64 InvMass() const;
-    m4 InvTensor() const;
+    // World space inverse inertia, refreshed by UpdateInertia once per step
+    const m3 &InvTensor() const;
+    void UpdateInertia(const SphereCollider *sphere, const OBBCollider *obb);
     void Init();
-    void Update(f64 step);
-    void ApplyForces();
     void AddRotationalImpulse(const v3 &point, const v3 &impulse);
     void AddLinearImpulse(const v3 &impulse);
-    void ApplyImpulse(RigidBody &other, const CollisionManifold &manifold, i32 c);
+    // Sleeping bodies are skipped by integration and the narrowphase until something touches or moves them
+    bool IsAwake() const;
+    void Wake();
+    void Sleep();
+    void ApplyImpulse(RigidBody &other, const ContactConstraint &contact, const ContactPoint &point, const v3 &impulse);
     bool ShowComponent();
     CollisionManifold FindCollisionFeatures(const RigidBody &other) const;
 
     std::vector<Ento> colliding_with;
+    // Raycast layers of the body, not serialized
+    u32 layers = PHYSICS_LAYER_DEFAULT;
+    // Fast spheres are swept against what lies in their path instead of tunneling through it, not serialized
+    bool continuous = false;
 
     REGISTER_COMPONENT(RigidBody, mass, friction, cor, is_trigger);
+
+   protected:
+    // The local inverse inertia is only rebuilt when the mass or the collider size change
+    f64 _inertia_mass = -1.0;
+    v3 _inertia_shape = v3(-1.0f);
+    v3 _inv_inertia_local = v3(0.0f);
+    m3 _inv_tensor = m3(0.0f);
+
+    // Static bodies are only awake on the steps their transform was moved
+    bool _awake = true;
+    f64 _sleep_time = 0.0;
+    // Union-find link, rebuilt every step, the island sleep time is only valid on the root
+    entt::entity _island = entt::null;
+    f64 _island_sleep_time = 0.0;
+
+    friend class Physics;
   };
 
 } // namespace axl
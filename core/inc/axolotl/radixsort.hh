@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <axolotl/types.hh>
+
+namespace axl {
+
+  // Sort key bits consumed by every radix pass
+  constexpr u32 RADIX_BITS = 8;
+  constexpr u32 RADIX_BUCKETS = 1u << RADIX_BITS;
+
+  // Sorts entries by their u64 key member, scratch is resized to match and holds garbage afterwards.
+  // Least significant digit first, so it is stable. Passes where every key has the same digit are skipped, within a
+  // frame most of the pass and program bits are.
+  template<typename Vector>
+  void RadixSort(Vector &entries, Vector &scratch) {
+    if (entries.size() < 2)
+      return;
+
+    scratch.resize(entries.size());
+    std::array<u32, RADIX_BUCKETS> offsets;
+    for (u32 shift = 0; shift < 64; shift += RADIX_BITS) {
+      offsets.fill(0);
+      for (const auto &entry : entries)
+        offsets[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++;
+      if (offsets[(entries[0].key >> shift) & (RADIX_BUCKETS - 1)] == entries.size())
+        continue;
+
+      u32 offset = 0;
+      for (u32 &bucket : offsets) {
+        u32 count = bucket;
+        bucket = offset;
+        offset += count;
+      }
+      for (const auto &entry : entries)
+        scratch[offsets[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
+      entries.swap(scratch);
+    }
+  }
+
+} // namespace axl
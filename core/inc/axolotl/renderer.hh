@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <axolotl/light.hh>
 #include <axolotl/line.hh>
 #include <axolotl/scene.hh>
@@ -9,6 +10,9 @@
 
 namespace axl {
 
+  // Slots of the per frame uniform buffer, the CPU writes one while the GPU may still read the others
+  constexpr u32 FRAME_UNIFORM_SLOTS = 3;
+
   class Window;
   class GUI;
 
@@ -19,6 +23,8 @@ namespace axl {
   class Transform;
   class Shader;
   class FrameBuffer;
+  class GPUTimer;
+  class LightClusters;
 
   class RendererPerformance {
    public:
@@ -43,7 +49,13 @@ namespace axl {
     u32 mesh_count;
     u32 vertex_count;
     u32 triangle_count;
+    // Meshes rejected by the frustum test and meshes that made it into the draw list
+    u32 culled_count;
+    u32 submitted_count;
     u32 draw_calls;
+    u32 instance_count;
+    u32 gl_calls_issued;
+    u32 gl_calls_elided;
 
     void StartCapture(f64 now);
     void EndCapture(f64 now, f64 delta);
@@ -67,6 +79,7 @@ namespace axl {
     void SetDirectionalLight(const Light &light);
 
     const RendererPerformance &GetPerformance() const;
+    const GPUTimer &GetGPUTimer() const;
 
    protected:
     friend class GUI;
@@ -80,12 +93,33 @@ namespace axl {
     std::vector<LinePrimitive *> _lines;
 
     std::unique_ptr<Grid> _grid;
+    std::unique_ptr<GPUTimer> _gpu_timer;
 
     bool _show_wireframe;
     bool _show_grid;
     v2i _size;
 
-    u32 _lights_uniform_buffer;
+    // Persistently mapped ring of FRAME_UNIFORM_SLOTS slots holding the lights and camera blocks, each fenced until
+    // the frame that read it is done
+    u32 _frame_uniform_buffer;
+    u8 *_frame_mapping;
+    u32 _frame_slot_size;
+    u32 _frame_camera_offset;
+    u32 _frame_slot;
+    std::array<void *, FRAME_UNIFORM_SLOTS> _frame_fences;
+
+    // Point lights and their per cluster lists, rebuilt every frame
+    std::unique_ptr<LightClusters> _light_clusters;
+    u32 _point_lights_buffer;
+    u32 _point_lights_capacity;
+    u32 _clusters_buffer;
+    u32 _clusters_capacity;
+    u32 _cluster_lights_buffer;
+    u32 _cluster_lights_capacity;
+
+    // Model and normal matrices of every draw, indexed by instance in the shaders
+    u32 _objects_buffer;
+    u32 _objects_capacity;
 
     Light _ambient_light;
     Light _directional_light;
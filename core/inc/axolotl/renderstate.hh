@@ -0,0 +1,95 @@
+#pragma once
+
+#include <axolotl/texture.hh>
+#include <axolotl/types.hh>
+
+namespace axl {
+
+  constexpr u32 MAX_UNIFORM_BUFFER_BINDINGS = 16;
+  constexpr u32 MAX_STORAGE_BUFFER_BINDINGS = 8;
+  // Cached value that has to be set before it can be trusted
+  constexpr u32 RENDER_STATE_UNKNOWN = ~0u;
+
+  // Every GL call the state cache can issue, swapped out to run it without a context
+  class GLDispatch {
+   public:
+    void (*UseProgram)(u32 program);
+    void (*BindVertexArray)(u32 vao);
+    void (*ActiveTexture)(u32 unit);
+    void (*BindTexture)(u32 target, u32 texture);
+    void (*BindBufferBase)(u32 target, u32 index, u32 buffer);
+    void (*BindBufferRange)(u32 target, u32 index, u32 buffer, u64 offset, u64 size);
+    void (*Enable)(u32 capability);
+    void (*Disable)(u32 capability);
+    void (*DepthFunc)(u32 func);
+    void (*CullFace)(u32 mode);
+    void (*PolygonMode)(u32 mode);
+  };
+
+  // Mirror of the bound GL state, only calls that actually change something reach the driver.
+  // Anything binding these objects behind its back has to call Invalidate() afterwards.
+  class RenderState {
+   public:
+    static void UseProgram(u32 program);
+    static void BindVertexArray(u32 vao);
+    static void BindTexture(u32 unit, u32 target, u32 texture);
+    static void BindUniformBuffer(u32 index, u32 buffer);
+    static void BindUniformBufferRange(u32 index, u32 buffer, u64 offset, u64 size);
+    static void BindStorageBuffer(u32 index, u32 buffer);
+    static void SetDepthTest(bool enabled);
+    static void SetCullFace(bool enabled);
+    static void SetDepthFunc(u32 func);
+    static void SetCullMode(u32 mode);
+    static void SetPolygonMode(u32 mode);
+
+    static u32 GetBoundTexture(u32 unit);
+
+    // Deleted names can be handed out again, they must not be taken as still bound
+    static void ForgetProgram(u32 program);
+    static void ForgetVertexArray(u32 vao);
+    static void ForgetTexture(u32 texture);
+
+    static void Invalidate();
+    static void ResetCounters();
+    static u32 GetIssuedCount();
+    static u32 GetElidedCount();
+
+    static void SetDispatch(const GLDispatch &dispatch);
+    static void ResetDispatch();
+
+   protected:
+    class TextureBinding {
+     public:
+      u32 target;
+      u32 texture;
+    };
+
+    // Whole buffer bindings have a size of 0
+    class BufferBinding {
+     public:
+      u32 buffer;
+      u64 offset;
+      u64 size;
+    };
+
+    static bool Changed(bool changed);
+
+    static GLDispatch _dispatch;
+
+    inline static u32 _program = RENDER_STATE_UNKNOWN;
+    inline static u32 _vao = RENDER_STATE_UNKNOWN;
+    inline static u32 _active_unit = RENDER_STATE_UNKNOWN;
+    inline static TextureBinding _textures[MAX_TEXTURE_UNITS];
+    inline static BufferBinding _uniform_buffers[MAX_UNIFORM_BUFFER_BINDINGS];
+    inline static u32 _storage_buffers[MAX_STORAGE_BUFFER_BINDINGS];
+    inline static i32 _depth_test = -1;
+    inline static i32 _cull_face = -1;
+    inline static u32 _depth_func = RENDER_STATE_UNKNOWN;
+    inline static u32 _cull_mode = RENDER_STATE_UNKNOWN;
+    inline static u32 _polygon_mode = RENDER_STATE_UNKNOWN;
+
+    inline static u32 _issued = 0;
+    inline static u32 _elided = 0;
+  };
+
+} // namespace axl
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <axolotl/broadphase.hh>
+#include <axolotl/contact.hh>
+#include <axolotl/hierarchy.hh>
+#include <axolotl/lookup.hh>
 #include <axolotl/types.hh>
+#include <axolotl/world.hh>
 #include <entt/entt.hpp>
 
 namespace axl {
@@ -9,6 +14,7 @@ namespace axl {
   class Window;
   class Camera;
   class Transform;
+  class Texture2D;
 
   class Ento;
 
@@ -25,12 +31,19 @@ namespace axl {
     Ento FromID(uuid id);
     Ento FromHandle(entt::entity handle);
     entt::registry &GetRegistry();
+    Broadphase &GetBroadphase();
+    ContactCache &GetContactCache();
+    PhysicsWorld &GetPhysicsWorld();
 
+    void UpdateTransforms();
     void PhysicsUpdate(f64 step);
     void
     Draw(Renderer &renderer, bool show_data = false, Camera *camera = nullptr, Transform *camera_transform = nullptr);
     json Serialize();
     void Deserialize(const json &data);
+    // Compact pool-by-pool format that is mapped straight from disk, JSON stays around for diffs and tooling
+    std::vector<u8> SerializeBinary();
+    bool DeserializeBinary(const std::filesystem::path &path);
 
     static void SetActiveScene(Scene *scene);
     static Scene *GetActiveScene();
@@ -40,6 +53,11 @@ namespace axl {
     friend class Ento;
     friend class FrameEditor;
 
+    void ClearForLoad(std::vector<Texture2D> &textures_tmp);
+    void InitComponents();
+    void DeserializePools(const json &j);
+    void DeserializeEntities(const json &j);
+
     template<typename T>
     T &GetComponent(entt::entity handle) {
       return _registry.get<T>(handle);
@@ -51,6 +69,12 @@ namespace axl {
     }
 
     entt::registry _registry;
+    HandleIndex _handle_index;
+    UUIDMap _uuid_index;
+    TransformHierarchy _transform_hierarchy;
+    Broadphase _broadphase;
+    ContactCache _contacts;
+    PhysicsWorld _physics_world;
     bool focused = false;
 
     static inline Scene *_active_scene;
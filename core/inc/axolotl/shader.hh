@@ -35,7 +35,13 @@ namespace axl {
     Last
   };
 
-  enum class AttributeLocation { Position = 0, Normal = 1, Tangent = 2, TexCoord = 3, Last };
+  enum class AttributeLocation {
+    Position = 0,
+    Normal = 1,
+    Tangent = 2,
+    TexCoord = 3,
+    Last = 4
+  };
 
   enum class UniformDataType {
     Vector2,
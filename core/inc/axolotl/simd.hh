@@ -0,0 +1,32 @@
+#pragma once
+
+#include <axolotl/types.hh>
+
+// AVX has to be enabled at build time (AXOLOTL_AVX), SSE2 is always there on x86-64.
+// AXOLOTL_NO_SIMD leaves only the scalar loops, the packet tests build with it to check them.
+#if defined(AXOLOTL_NO_SIMD)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define AXL_SIMD_AVX 1
+#define AXL_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AXL_SIMD_SSE 1
+#endif
+
+namespace axl {
+
+#if defined(AXL_SIMD_AVX)
+  constexpr u32 SIMD_WIDTH = 8;
+#elif defined(AXL_SIMD_SSE)
+  constexpr u32 SIMD_WIDTH = 4;
+#else
+  constexpr u32 SIMD_WIDTH = 1;
+#endif
+
+  // Arrays fed to the SIMD kernels are padded to this, so they never need a scalar tail
+  inline u32 SIMDPadded(u32 count) {
+    return (count + 7) & ~7u;
+  }
+
+} // namespace axl
@@ -32,12 +32,15 @@ namespace axl {
     bool IsDirty() const;
     bool WasDirty();
 
+    m4 GetLocalMatrix() const;
     m4 GetModelMatrix();
     m4 GetParentModelMatrix();
 
     REGISTER_COMPONENT(Transform, _position, _scale, _rotation)
 
    protected:
+    friend class TransformHierarchy;
+
     v3 _position = v3(0.0f);
     v3 _scale = v3(0.0f);
     quat _rotation = quat();
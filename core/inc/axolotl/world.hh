@@ -0,0 +1,41 @@
+#pragma once
+
+#include <axolotl/types.hh>
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace axl {
+
+  // Structure of arrays copy of every awake rigid body, so integration runs over contiguous f32 lanes.
+  // Bodies are laid out in group<Transform, RigidBody> order, the components stay the source of truth
+  // and are refreshed from and written back to the arrays around every kernel.
+  class PhysicsWorld {
+   public:
+    // Copies the body state out of the components, applying gravity and refreshing the inertia tensors
+    void Gather(entt::registry &registry);
+    // Gravity, damping and velocity integration, writes the velocities back to the components
+    void IntegrateVelocities(entt::registry &registry, f64 step);
+    // Re-reads the solved velocities and moves the transforms
+    void IntegratePositions(entt::registry &registry, f64 step);
+
+    u32 GetBodyCount() const;
+
+   protected:
+    void Resize(u32 count);
+
+    u32 _count = 0;
+    std::vector<entt::entity> _entities;
+    std::vector<u8> _angular;
+
+    // There are no inverse mass or inverse inertia lanes. The world space inverse inertia of a rotated box is a full
+    // m3 that three diagonal lanes cannot hold, so Gather multiplies it with the torque once per body. Forces get
+    // the same treatment with the inverse mass, which leaves both kernels doing velocity += acceleration * step.
+    std::vector<f32> _position[3];
+    std::vector<f32> _velocity[3];
+    std::vector<f32> _acceleration[3];
+
+    std::vector<f32> _angular_velocity[3];
+    std::vector<f32> _angular_acceleration[3];
+  };
+
+} // namespace axl
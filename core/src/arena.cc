@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <axolotl/arena.hh>
+#include <cstdlib>
+
+namespace axl {
+
+  Arena::Arena(size_t block_size):
+    _block_size(block_size),
+    _offset(0),
+    _used(0),
+    _last(nullptr),
+    _system_allocations(0) { }
+
+  Arena::~Arena() {
+    for (Block &block : _blocks)
+      std::free(block.data);
+  }
+
+  void Arena::AddBlock(size_t min_size) {
+    Block block;
+    block.size = std::max(_block_size, min_size);
+    block.data = (u8 *)std::malloc(block.size);
+    AXL_ASSERT_MESSAGE(block.data, "Arena could not allocate {} bytes", block.size);
+
+    _blocks.push_back(block);
+    _offset = 0;
+    _system_allocations++;
+  }
+
+  void *Arena::Allocate(size_t size, size_t alignment) {
+    if (size == 0)
+      size = 1;
+
+    if (!_blocks.empty()) {
+      Block &block = _blocks.back();
+      size_t start = (_offset + alignment - 1) & ~(alignment - 1);
+      if (start + size <= block.size) {
+        _used += start + size - _offset;
+        _offset = start + size;
+        _last = block.data + start;
+        return _last;
+      }
+    }
+
+    // Blocks come from malloc, aligned to max_align_t, so a fresh one only needs room for the size itself
+    AddBlock(size + alignment);
+    Block &block = _blocks.back();
+    size_t start = ((size_t)block.data + alignment - 1) & ~(alignment - 1);
+    start -= (size_t)block.data;
+    _used += start + size;
+    _offset = start + size;
+    _last = block.data + start;
+    return _last;
+  }
+
+  void Arena::Free(void *data, size_t size) {
+    if (!data || data != _last)
+      return;
+
+    size_t start = _last - _blocks.back().data;
+    _used -= _offset - start;
+    _offset = start;
+    _last = nullptr;
+  }
+
+  void Arena::Reset() {
+    if (_blocks.size() > 1) {
+      size_t capacity = GetCapacity();
+      for (Block &block : _blocks)
+        std::free(block.data);
+      _blocks.clear();
+      AddBlock(capacity);
+    }
+
+    _offset = 0;
+    _used = 0;
+    _last = nullptr;
+    _system_allocations = 0;
+  }
+
+  size_t Arena::GetUsed() const {
+    return _used;
+  }
+
+  size_t Arena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block &block : _blocks)
+      capacity += block.size;
+    return capacity;
+  }
+
+  u32 Arena::GetSystemAllocations() const {
+    return _system_allocations;
+  }
+
+  Arena &Arena::GetFrameArena() {
+    static Arena arena;
+    return arena;
+  }
+
+} // namespace axl
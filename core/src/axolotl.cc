@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <axolotl/axolotl.hh>
 #include <axolotl/component.hh>
+#include <axolotl/jobs.hh>
 #include <axolotl/shader.hh>
 #include <ergo/path.hh>
 
@@ -33,6 +34,12 @@ namespace axl {
 
     REGISTER_COMPONENT_DATA_TYPE(Color);
     REGISTER_COMPONENT_DATA_TYPE(uuid);
+
+    JobSystem::Init();
+  }
+
+  void Axolotl::Terminate() {
+    JobSystem::Terminate();
   }
 
   std::string Axolotl::GetDistDir() {
@@ -0,0 +1,82 @@
+#include <axolotl/binary.hh>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace axl {
+
+#ifdef _WIN32
+
+  MappedFile::MappedFile(const std::filesystem::path &path) {
+    _file = CreateFileW(
+      path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE) {
+      _file = nullptr;
+      log::error("Could not open {}", path.string());
+      return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0)
+      return;
+
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) {
+      log::error("Could not map {}", path.string());
+      return;
+    }
+
+    _data = (const u8 *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    _size = _data ? (size_t)size.QuadPart : 0;
+  }
+
+  MappedFile::~MappedFile() {
+    if (_data)
+      UnmapViewOfFile(_data);
+    if (_mapping)
+      CloseHandle(_mapping);
+    if (_file)
+      CloseHandle(_file);
+  }
+
+#else
+
+  MappedFile::MappedFile(const std::filesystem::path &path) {
+    i32 fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      log::error("Could not open {}", path.string());
+      return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        _data = (const u8 *)data;
+        _size = info.st_size;
+        // The whole file is read front to back
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+      } else {
+        log::error("Could not map {}", path.string());
+      }
+    }
+
+    // The mapping keeps the file alive on its own
+    close(fd);
+  }
+
+  MappedFile::~MappedFile() {
+    if (_data)
+      munmap((void *)_data, _size);
+  }
+
+#endif
+
+} // namespace axl
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <axolotl/broadphase.hh>
+#include <axolotl/simd.hh>
+
+namespace axl {
+
+  static f32 SurfaceArea(const v3 &min, const v3 &max) {
+    v3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+
+  static bool Contains(const v3 &outer_min, const v3 &outer_max, const v3 &inner_min, const v3 &inner_max) {
+    return outer_min.x <= inner_min.x && outer_min.y <= inner_min.y && outer_min.z <= inner_min.z &&
+           inner_max.x <= outer_max.x && inner_max.y <= outer_max.y && inner_max.z <= outer_max.z;
+  }
+
+  void RayPacket::Set(u32 index, const v3 &origin, const v3 &direction, f32 max_distance) {
+    for (i32 axis = 0; axis < 3; ++axis) {
+      // Keeps the slabs finite, 0 * inf would poison the lane with a NaN
+      f32 d = direction[axis];
+      if (abs(d) < std::numeric_limits<f32>::epsilon())
+        d = std::numeric_limits<f32>::epsilon();
+
+      this->origin[axis][index] = origin[axis];
+      inv_direction[axis][index] = 1.0f / d;
+    }
+    this->max_distance[index] = max_distance;
+  }
+
+  Broadphase::Broadphase(): _root(BROADPHASE_NULL_NODE), _free_list(BROADPHASE_NULL_NODE), _stamp(0) { }
+
+  void Broadphase::Clear() {
+    _nodes.clear();
+    _proxies.clear();
+    _root = BROADPHASE_NULL_NODE;
+    _free_list = BROADPHASE_NULL_NODE;
+  }
+
+  u32 Broadphase::GetProxyCount() const {
+    return _proxies.size();
+  }
+
+  i32 Broadphase::AllocateNode() {
+    if (_free_list == BROADPHASE_NULL_NODE) {
+      _nodes.emplace_back();
+      _free_list = _nodes.size() - 1;
+      _nodes[_free_list].parent = BROADPHASE_NULL_NODE;
+    }
+
+    i32 index = _free_list;
+    BroadphaseNode &node = _nodes[index];
+    _free_list = node.parent;
+
+    node.parent = BROADPHASE_NULL_NODE;
+    node.left = BROADPHASE_NULL_NODE;
+    node.right = BROADPHASE_NULL_NODE;
+    node.height = 0;
+    node.entity = entt::null;
+    node.stamp = _stamp;
+    return index;
+  }
+
+  void Broadphase::FreeNode(i32 index) {
+    // Free nodes are chained through their parent index
+    _nodes[index].parent = _free_list;
+    _nodes[index].height = -1;
+    _free_list = index;
+  }
+
+  void Broadphase::Begin() {
+    _stamp++;
+  }
+
+  void Broadphase::Update(entt::entity entity, const v3 &min, const v3 &max, u32 layers) {
+    auto itr = _proxies.find(entity);
+    if (itr == _proxies.end()) {
+      i32 leaf = AllocateNode();
+      BroadphaseNode &node = _nodes[leaf];
+      node.entity = entity;
+      node.layers = layers;
+      node.bounds_min = min;
+      node.bounds_max = max;
+      node.min = min - v3(BROADPHASE_MARGIN);
+      node.max = max + v3(BROADPHASE_MARGIN);
+
+      InsertLeaf(leaf);
+      _proxies.insert({ entity, leaf });
+      return;
+    }
+
+    i32 leaf = itr->second;
+    BroadphaseNode &node = _nodes[leaf];
+    node.stamp = _stamp;
+    node.layers = layers;
+    node.bounds_min = min;
+    node.bounds_max = max;
+
+    if (Contains(node.min, node.max, min, max))
+      return;
+
+    RemoveLeaf(leaf);
+    _nodes[leaf].min = min - v3(BROADPHASE_MARGIN);
+    _nodes[leaf].max = max + v3(BROADPHASE_MARGIN);
+    InsertLeaf(leaf);
+  }
+
+  void Broadphase::End() {
+    for (auto itr = _proxies.begin(); itr != _proxies.end();) {
+      if (_nodes[itr->second].stamp == _stamp) {
+        ++itr;
+        continue;
+      }
+
+      RemoveLeaf(itr->second);
+      FreeNode(itr->second);
+      itr = _proxies.erase(itr);
+    }
+  }
+
+  void Broadphase::QueryPairs(FrameVector<BroadphasePair> &pairs) const {
+    pairs.clear();
+
+    for (auto [entity, leaf] : _proxies) {
+      const BroadphaseNode &node = _nodes[leaf];
+
+      Query(node.bounds_min, node.bounds_max, [&](i32 other) {
+        const BroadphaseNode &other_node = _nodes[other];
+        // Every overlap is found from both sides, keep only one of them
+        if (!(node.entity < other_node.entity))
+          return true;
+        if (!Overlaps(node.bounds_min, node.bounds_max, other_node.bounds_min, other_node.bounds_max))
+          return true;
+
+        pairs.push_back({ node.entity, other_node.entity });
+        return true;
+      });
+    }
+
+    // Hash map iteration order is not stable, keep the solver input deterministic
+    std::sort(pairs.begin(), pairs.end(), [](const BroadphasePair &a, const BroadphasePair &b) {
+      if (a.a != b.a)
+        return a.a < b.a;
+      return a.b < b.b;
+    });
+  }
+
+  u32 Broadphase::RayMask(const RayPacket &packet, const BroadphaseNode &node, u32 active) const {
+    u32 mask = 0;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    const __m256 min_x_8 = _mm256_set1_ps(node.min.x);
+    const __m256 min_y_8 = _mm256_set1_ps(node.min.y);
+    const __m256 min_z_8 = _mm256_set1_ps(node.min.z);
+    const __m256 max_x_8 = _mm256_set1_ps(node.max.x);
+    const __m256 max_y_8 = _mm256_set1_ps(node.max.y);
+    const __m256 max_z_8 = _mm256_set1_ps(node.max.z);
+
+    for (; i < packet.count; i += 8) {
+      if (!((active >> i) & 0xff))
+        continue;
+
+      __m256 inv_x = _mm256_load_ps(packet.inv_direction[0] + i);
+      __m256 inv_y = _mm256_load_ps(packet.inv_direction[1] + i);
+      __m256 inv_z = _mm256_load_ps(packet.inv_direction[2] + i);
+      __m256 origin_x = _mm256_load_ps(packet.origin[0] + i);
+      __m256 origin_y = _mm256_load_ps(packet.origin[1] + i);
+      __m256 origin_z = _mm256_load_ps(packet.origin[2] + i);
+
+      __m256 t0_x = _mm256_mul_ps(_mm256_sub_ps(min_x_8, origin_x), inv_x);
+      __m256 t1_x = _mm256_mul_ps(_mm256_sub_ps(max_x_8, origin_x), inv_x);
+      __m256 t0_y = _mm256_mul_ps(_mm256_sub_ps(min_y_8, origin_y), inv_y);
+      __m256 t1_y = _mm256_mul_ps(_mm256_sub_ps(max_y_8, origin_y), inv_y);
+      __m256 t0_z = _mm256_mul_ps(_mm256_sub_ps(min_z_8, origin_z), inv_z);
+      __m256 t1_z = _mm256_mul_ps(_mm256_sub_ps(max_z_8, origin_z), inv_z);
+
+      __m256 t_near = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t0_x, t1_x), _mm256_min_ps(t0_y, t1_y)),
+                                    _mm256_max_ps(_mm256_min_ps(t0_z, t1_z), _mm256_setzero_ps()));
+      __m256 t_far = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t0_x, t1_x), _mm256_max_ps(t0_y, t1_y)),
+                                   _mm256_min_ps(_mm256_max_ps(t0_z, t1_z), _mm256_load_ps(packet.max_distance + i)));
+
+      mask |= (u32)_mm256_movemask_ps(_mm256_cmp_ps(t_near, t_far, _CMP_LE_OQ)) << i;
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    const __m128 min_x_4 = _mm_set1_ps(node.min.x);
+    const __m128 min_y_4 = _mm_set1_ps(node.min.y);
+    const __m128 min_z_4 = _mm_set1_ps(node.min.z);
+    const __m128 max_x_4 = _mm_set1_ps(node.max.x);
+    const __m128 max_y_4 = _mm_set1_ps(node.max.y);
+    const __m128 max_z_4 = _mm_set1_ps(node.max.z);
+
+    for (; i < packet.count; i += 4) {
+      if (!((active >> i) & 0xf))
+        continue;
+
+      __m128 inv_x = _mm_load_ps(packet.inv_direction[0] + i);
+      __m128 inv_y = _mm_load_ps(packet.inv_direction[1] + i);
+      __m128 inv_z = _mm_load_ps(packet.inv_direction[2] + i);
+      __m128 origin_x = _mm_load_ps(packet.origin[0] + i);
+      __m128 origin_y = _mm_load_ps(packet.origin[1] + i);
+      __m128 origin_z = _mm_load_ps(packet.origin[2] + i);
+
+      __m128 t0_x = _mm_mul_ps(_mm_sub_ps(min_x_4, origin_x), inv_x);
+      __m128 t1_x = _mm_mul_ps(_mm_sub_ps(max_x_4, origin_x), inv_x);
+      __m128 t0_y = _mm_mul_ps(_mm_sub_ps(min_y_4, origin_y), inv_y);
+      __m128 t1_y = _mm_mul_ps(_mm_sub_ps(max_y_4, origin_y), inv_y);
+      __m128 t0_z = _mm_mul_ps(_mm_sub_ps(min_z_4, origin_z), inv_z);
+      __m128 t1_z = _mm_mul_ps(_mm_sub_ps(max_z_4, origin_z), inv_z);
+
+      __m128 t_near = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0_x, t1_x), _mm_min_ps(t0_y, t1_y)),
+                                 _mm_max_ps(_mm_min_ps(t0_z, t1_z), _mm_setzero_ps()));
+      __m128 t_far = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0_x, t1_x), _mm_max_ps(t0_y, t1_y)),
+                                _mm_min_ps(_mm_max_ps(t0_z, t1_z), _mm_load_ps(packet.max_distance + i)));
+
+      mask |= (u32)_mm_movemask_ps(_mm_cmple_ps(t_near, t_far)) << i;
+    }
+#endif
+
+    for (; i < packet.count; ++i) {
+      if (!(active & (1u << i)))
+        continue;
+
+      f32 t_near = 0.0f;
+      f32 t_far = packet.max_distance[i];
+      for (i32 axis = 0; axis < 3; ++axis) {
+        f32 t0 = (node.min[axis] - packet.origin[axis][i]) * packet.inv_direction[axis][i];
+        f32 t1 = (node.max[axis] - packet.origin[axis][i]) * packet.inv_direction[axis][i];
+        t_near = std::max(t_near, std::min(t0, t1));
+        t_far = std::min(t_far, std::max(t0, t1));
+      }
+
+      if (t_near <= t_far)
+        mask |= 1u << i;
+    }
+
+    // Lanes past the packet count hold whatever was there, only the active rays are trusted
+    return mask & active;
+  }
+
+  void Broadphase::InsertLeaf(i32 leaf) {
+    if (_root == BROADPHASE_NULL_NODE) {
+      _root = leaf;
+      _nodes[leaf].parent = BROADPHASE_NULL_NODE;
+      return;
+    }
+
+    v3 leaf_min = _nodes[leaf].min;
+    v3 leaf_max = _nodes[leaf].max;
+
+    // Find the best sibling with the surface area heuristic
+    i32 index = _root;
+    while (!_nodes[index].IsLeaf()) {
+      const BroadphaseNode &node = _nodes[index];
+
+      f32 area = SurfaceArea(node.min, node.max);
+      f32 combined_area = SurfaceArea(glm::min(node.min, leaf_min), glm::max(node.max, leaf_max));
+
+      f32 cost = 2.0f * combined_area;
+      f32 inheritance_cost = 2.0f * (combined_area - area);
+
+      auto child_cost = [&](i32 child) {
+        const BroadphaseNode &c = _nodes[child];
+        f32 c_area = SurfaceArea(glm::min(c.min, leaf_min), glm::max(c.max, leaf_max));
+        if (c.IsLeaf())
+          return c_area + inheritance_cost;
+        return (c_area - SurfaceArea(c.min, c.max)) + inheritance_cost;
+      };
+
+      f32 cost_left = child_cost(node.left);
+      f32 cost_right = child_cost(node.right);
+
+      if (cost < cost_left && cost < cost_right)
+        break;
+
+      index = cost_left < cost_right ? node.left : node.right;
+    }
+
+    i32 sibling = index;
+    i32 old_parent = _nodes[sibling].parent;
+    i32 new_parent = AllocateNode();
+
+    _nodes[new_parent].parent = old_parent;
+    _nodes[new_parent].min = glm::min(leaf_min, _nodes[sibling].min);
+    _nodes[new_parent].max = glm::max(leaf_max, _nodes[sibling].max);
+    _nodes[new_parent].height = _nodes[sibling].height + 1;
+    _nodes[new_parent].left = sibling;
+    _nodes[new_parent].right = leaf;
+    _nodes[sibling].parent = new_parent;
+    _nodes[leaf].parent = new_parent;
+
+    if (old_parent == BROADPHASE_NULL_NODE) {
+      _root = new_parent;
+    } else if (_nodes[old_parent].left == sibling) {
+      _nodes[old_parent].left = new_parent;
+    } else {
+      _nodes[old_parent].right = new_parent;
+    }
+
+    Refit(_nodes[leaf].parent);
+  }
+
+  void Broadphase::RemoveLeaf(i32 leaf) {
+    if (leaf == _root) {
+      _root = BROADPHASE_NULL_NODE;
+      return;
+    }
+
+    i32 parent = _nodes[leaf].parent;
+    i32 grand_parent = _nodes[parent].parent;
+    i32 sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+
+    if (grand_parent == BROADPHASE_NULL_NODE) {
+      _root = sibling;
+      _nodes[sibling].parent = BROADPHASE_NULL_NODE;
+      FreeNode(parent);
+      return;
+    }
+
+    if (_nodes[grand_parent].left == parent)
+      _nodes[grand_parent].left = sibling;
+    else
+      _nodes[grand_parent].right = sibling;
+    _nodes[sibling].parent = grand_parent;
+    FreeNode(parent);
+
+    Refit(grand_parent);
+  }
+
+  void Broadphase::Refit(i32 index) {
+    while (index != BROADPHASE_NULL_NODE) {
+      index = Balance(index);
+
+      BroadphaseNode &node = _nodes[index];
+      const BroadphaseNode &left = _nodes[node.left];
+      const BroadphaseNode &right = _nodes[node.right];
+
+      node.height = 1 + std::max(left.height, right.height);
+      node.min = glm::min(left.min, right.min);
+      node.max = glm::max(left.max, right.max);
+
+      index = node.parent;
+    }
+  }
+
+  // Tree rotation, same idea as an AVL tree. Returns the new root of the subtree.
+  i32 Broadphase::Balance(i32 a) {
+    BroadphaseNode &node_a = _nodes[a];
+    if (node_a.IsLeaf() || node_a.height < 2)
+      return a;
+
+    i32 b = node_a.left;
+    i32 c = node_a.right;
+    BroadphaseNode &node_b = _nodes[b];
+    BroadphaseNode &node_c = _nodes[c];
+
+    i32 balance = node_c.height - node_b.height;
+
+    // Rotate C up
+    if (balance > 1) {
+      i32 f = node_c.left;
+      i32 g = node_c.right;
+      BroadphaseNode &node_f = _nodes[f];
+      BroadphaseNode &node_g = _nodes[g];
+
+      node_c.left = a;
+      node_c.parent = node_a.parent;
+      node_a.parent = c;
+
+      if (node_c.parent == BROADPHASE_NULL_NODE)
+        _root = c;
+      else if (_nodes[node_c.parent].left == a)
+        _nodes[node_c.parent].left = c;
+      else
+        _nodes[node_c.parent].right = c;
+
+      if (node_f.height > node_g.height) {
+        node_c.right = f;
+        node_a.right = g;
+        node_g.parent = a;
+        node_a.min = glm::min(node_b.min, node_g.min);
+        node_a.max = glm::max(node_b.max, node_g.max);
+        node_c.min = glm::min(node_a.min, node_f.min);
+        node_c.max = glm::max(node_a.max, node_f.max);
+        node_a.height = 1 + std::max(node_b.height, node_g.height);
+        node_c.height = 1 + std::max(node_a.height, node_f.height);
+      } else {
+        node_c.right = g;
+        node_a.right = f;
+        node_f.parent = a;
+        node_a.min = glm::min(node_b.min, node_f.min);
+        node_a.max = glm::max(node_b.max, node_f.max);
+        node_c.min = glm::min(node_a.min, node_g.min);
+        node_c.max = glm::max(node_a.max, node_g.max);
+        node_a.height = 1 + std::max(node_b.height, node_f.height);
+        node_c.height = 1 + std::max(node_a.height, node_g.height);
+      }
+
+      return c;
+    }
+
+    // Rotate B up
+    if (balance < -1) {
+      i32 d = node_b.left;
+      i32 e = node_b.right;
+      BroadphaseNode &node_d = _nodes[d];
+      BroadphaseNode &node_e = _nodes[e];
+
+      node_b.left = a;
+      node_b.parent = node_a.parent;
+      node_a.parent = b;
+
+      if (node_b.parent == BROADPHASE_NULL_NODE)
+        _root = b;
+      else if (_nodes[node_b.parent].left == a)
+        _nodes[node_b.parent].left = b;
+      else
+        _nodes[node_b.parent].right = b;
+
+      if (node_d.height > node_e.height) {
+        node_b.right = d;
+        node_a.left = e;
+        node_e.parent = a;
+        node_a.min = glm::min(node_c.min, node_e.min);
+        node_a.max = glm::max(node_c.max, node_e.max);
+        node_b.min = glm::min(node_a.min, node_d.min);
+        node_b.max = glm::max(node_a.max, node_d.max);
+        node_a.height = 1 + std::max(node_c.height, node_e.height);
+        node_b.height = 1 + std::max(node_a.height, node_d.height);
+      } else {
+        node_b.right = e;
+        node_a.left = d;
+        node_d.parent = a;
+        node_a.min = glm::min(node_c.min, node_d.min);
+        node_a.max = glm::max(node_c.max, node_d.max);
+        node_b.min = glm::min(node_a.min, node_e.min);
+        node_b.max = glm::max(node_a.max, node_e.max);
+        node_a.height = 1 + std::max(node_c.height, node_d.height);
+        node_b.height = 1 + std::max(node_a.height, node_e.height);
+      }
+
+      return b;
+    }
+
+    return a;
+  }
+
+} // namespace axl
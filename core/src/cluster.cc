@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <axolotl/cluster.hh>
+
+namespace axl {
+
+  // Keeps the logarithmic slicing finite for projections starting at or behind the eye
+  constexpr f32 CLUSTER_MIN_NEAR = 0.01f;
+
+  LightClusters::LightClusters(): _depth_parameters(0.0f), _ranges(CLUSTER_COUNT, v2u(0)) { }
+
+  const v4 &LightClusters::GetDepthParameters() const {
+    return _depth_parameters;
+  }
+
+  const std::vector<v2u> &LightClusters::GetRanges() const {
+    return _ranges;
+  }
+
+  const std::vector<u32> &LightClusters::GetIndices() const {
+    return _indices;
+  }
+
+  i32 LightClusters::Slice(f32 depth) const {
+    if (depth <= _depth_parameters.x)
+      return 0;
+    i32 slice = (i32)floor(log(depth) * _depth_parameters.z + _depth_parameters.w);
+    return std::clamp(slice, 0, (i32)CLUSTER_GRID_Z - 1);
+  }
+
+  void LightClusters::Build(const m4 &view, const m4 &projection, const LightData *lights, u32 count) {
+    // Depth range of glm's right handed projections, perspective ones have a 0 in the last column
+    f32 near, far;
+    if (projection[3][3] == 0.0f) {
+      near = projection[3][2] / (projection[2][2] - 1.0f);
+      far = projection[3][2] / (projection[2][2] + 1.0f);
+    } else {
+      near = (projection[3][2] + 1.0f) / projection[2][2];
+      far = (projection[3][2] - 1.0f) / projection[2][2];
+    }
+    near = std::max(near, CLUSTER_MIN_NEAR);
+    far = std::max(far, near * 2.0f);
+
+    f32 scale = (f32)CLUSTER_GRID_Z / log(far / near);
+    _depth_parameters = v4(near, far, scale, -log(near) * scale);
+
+    const v3i grid(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z);
+    _light_min.assign(count, v3i(0));
+    _light_max.assign(count, v3i(-1));
+
+    for (u32 i = 0; i < count; ++i) {
+      const LightData &light = lights[i];
+      if (light.range <= 0.0f)
+        continue;
+
+      v3 center = v3(view * light.position);
+      f32 radius = light.range;
+      f32 min_depth = -center.z - radius;
+      f32 max_depth = -center.z + radius;
+      if (max_depth < near || min_depth > far)
+        continue;
+
+      v3i cluster_min(0, 0, Slice(min_depth));
+      v3i cluster_max(grid.x - 1, grid.y - 1, Slice(max_depth));
+
+      // Lights crossing the near plane cannot be projected, they cover the whole screen
+      if (min_depth > near) {
+        v2 ndc_min(std::numeric_limits<f32>::max());
+        v2 ndc_max(std::numeric_limits<f32>::lowest());
+        for (i32 corner = 0; corner < 8; ++corner) {
+          v3 offset((corner & 1) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 4) ? radius : -radius);
+          v4 clip = projection * v4(center + offset, 1.0f);
+          v2 ndc = v2(clip) / clip.w;
+          ndc_min = glm::min(ndc_min, ndc);
+          ndc_max = glm::max(ndc_max, ndc);
+        }
+        if (ndc_max.x < -1.0f || ndc_min.x > 1.0f || ndc_max.y < -1.0f || ndc_min.y > 1.0f)
+          continue;
+
+        for (i32 axis = 0; axis < 2; ++axis) {
+          cluster_min[axis] = std::clamp((i32)floor((ndc_min[axis] * 0.5f + 0.5f) * grid[axis]), 0, grid[axis] - 1);
+          cluster_max[axis] = std::clamp((i32)floor((ndc_max[axis] * 0.5f + 0.5f) * grid[axis]), 0, grid[axis] - 1);
+        }
+      }
+
+      _light_min[i] = cluster_min;
+      _light_max[i] = cluster_max;
+    }
+
+    // Count, prefix sum, then fill, so every cluster gets a contiguous run without a per cluster cap
+    for (v2u &range : _ranges)
+      range = v2u(0);
+    for (u32 i = 0; i < count; ++i)
+      for (i32 z = _light_min[i].z; z <= _light_max[i].z; ++z)
+        for (i32 y = _light_min[i].y; y <= _light_max[i].y; ++y)
+          for (i32 x = _light_min[i].x; x <= _light_max[i].x; ++x)
+            _ranges[x + grid.x * (y + grid.y * z)].y++;
+
+    u32 offset = 0;
+    for (v2u &range : _ranges) {
+      range.x = offset;
+      offset += range.y;
+      range.y = 0;
+    }
+
+    _indices.resize(offset);
+    for (u32 i = 0; i < count; ++i)
+      for (i32 z = _light_min[i].z; z <= _light_max[i].z; ++z)
+        for (i32 y = _light_min[i].y; y <= _light_max[i].y; ++y)
+          for (i32 x = _light_min[i].x; x <= _light_max[i].x; ++x) {
+            v2u &range = _ranges[x + grid.x * (y + grid.y * z)];
+            _indices[range.x + range.y++] = i;
+          }
+  }
+
+} // namespace axl
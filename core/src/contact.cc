@@ -0,0 +1,65 @@
+#include <axolotl/contact.hh>
+
+namespace axl {
+
+  void ContactCache::Begin() {
+    _stamp++;
+    _active.clear();
+    _sleeping.clear();
+  }
+
+  ContactConstraint &ContactCache::Get(entt::entity a, entt::entity b) {
+    auto [itr, inserted] = _contacts.try_emplace(ContactKey { a, b });
+    ContactConstraint &contact = itr->second;
+
+    // Impulses cached for other bodies must not be warm started on these
+    if (inserted || contact.a != a || contact.b != b) {
+      contact.a = a;
+      contact.b = b;
+      contact.points.clear();
+    }
+
+    contact.stamp = _stamp;
+    _active.push_back(&contact);
+    return contact;
+  }
+
+  ContactConstraint *ContactCache::Keep(entt::entity a, entt::entity b) {
+    auto itr = _contacts.find(ContactKey { a, b });
+    if (itr == _contacts.end())
+      return nullptr;
+
+    ContactConstraint &contact = itr->second;
+    contact.stamp = _stamp;
+    _sleeping.push_back(&contact);
+    return &contact;
+  }
+
+  void ContactCache::End() {
+    for (auto itr = _contacts.begin(); itr != _contacts.end();) {
+      if (itr->second.stamp != _stamp)
+        itr = _contacts.erase(itr);
+      else
+        ++itr;
+    }
+  }
+
+  void ContactCache::Clear() {
+    _contacts.clear();
+    _active.clear();
+    _sleeping.clear();
+  }
+
+  std::vector<ContactConstraint *> &ContactCache::GetActive() {
+    return _active;
+  }
+
+  std::vector<ContactConstraint *> &ContactCache::GetSleeping() {
+    return _sleeping;
+  }
+
+  u32 ContactCache::GetCount() const {
+    return _contacts.size();
+  }
+
+} // namespace axl
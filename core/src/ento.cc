@@ -77,6 +77,7 @@ namespace axl {
   void Ento::SetParent(Ento parent) {
     HierarchyComponent &hierarchy = GetComponent<HierarchyComponent>();
     hierarchy.parent = parent.id;
+    scene->_transform_hierarchy.Invalidate();
   }
 
   std::vector<Ento> Ento::Children() {
@@ -107,9 +108,4 @@ namespace axl {
     return j;
   }
 
-  void Ento::ClearMaps() {
-    _uuid_ento_map.clear();
-    _handle_ento_map.clear();
-  }
-
 } // namespace axl
@@ -111,6 +111,10 @@ namespace axl {
     _height = height;
   }
 
+  v2u FrameBuffer::GetSize() const {
+    return v2u(_width, _height);
+  }
+
   Texture2D FrameBuffer::GetTexture(FrameBufferTexture texture) {
     return *_textures[(i32)texture];
   }
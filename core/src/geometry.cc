@@ -5,6 +5,13 @@
 
 namespace axl {
 
+  // Padding for the box-box projections, a null cross product of parallel edges must not separate the boxes
+  constexpr f32 OBB_PARALLEL_EPSILON = 1e-5f;
+  // Another axis only replaces the best one found so far when it is shallower by this much, keeps the reference face
+  // from flipping between frames on resting boxes
+  constexpr f32 OBB_RELATIVE_TOLERANCE = 0.98f;
+  constexpr f32 OBB_ABSOLUTE_TOLERANCE = 0.001f;
+
   bool AABBSphereInside(const AABBCollider &aabb, const SphereCollider &sphere) {
     v3 closest = aabb.ClosestPoint(sphere.position);
     f64 dist_sqr = length2(sphere.position - closest);
@@ -105,8 +112,8 @@ namespace axl {
     t[4] = (min.z - ray.position.z) / dir.z;
     t[5] = (max.z - ray.position.z) / dir.z;
 
-    f64 t_min = fmaxf(fmaxf(fminf(t[0], t[1]), fminf(t[2], t[3])), fminf(t[4], t[5]));
-    f64 t_max = fminf(fminf(fmaxf(t[0], t[1]), fmaxf(t[2], t[3])), fmaxf(t[4], t[5]));
+    f64 t_min = std::max(std::max(std::min(t[0], t[1]), std::min(t[2], t[3])), std::min(t[4], t[5]));
+    f64 t_max = std::min(std::min(std::max(t[0], t[1]), std::max(t[2], t[3])), std::max(t[4], t[5]));
 
     if (t_min > t_max || t_max < 0.0f)
       return -1.0f;
@@ -134,8 +141,8 @@ namespace axl {
       t[i * 2 + 1] = (e[i] - obb.size[i]) / f[i];
     }
 
-    f64 t_min = fmaxf(fmaxf(fminf(t[0], t[1]), fminf(t[2], t[3])), fminf(t[4], t[5]));
-    f64 t_max = fminf(fminf(fmaxf(t[0], t[1]), fmaxf(t[2], t[3])), fmaxf(t[4], t[5]));
+    f64 t_min = std::max(std::max(std::min(t[0], t[1]), std::min(t[2], t[3])), std::min(t[4], t[5]));
+    f64 t_max = std::min(std::min(std::max(t[0], t[1]), std::max(t[2], t[3])), std::max(t[4], t[5]));
 
     if (t_min > t_max || t_max < 0.0f)
       return -1.0f;
@@ -214,6 +221,10 @@ namespace axl {
     return position + diff;
   }
 
+  AABBCollider SphereCollider::GetBounds() const {
+    return AABBCollider(position, v3((f32)radius));
+  }
+
   bool AABBCollider::PointInside(const v3 &point) const {
     v3 min = GetMin();
     v3 max = GetMax();
@@ -359,6 +370,14 @@ namespace axl {
     return result;
   }
 
+  AABBCollider OBBCollider::GetBounds() const {
+    // Project every box axis onto the world axes
+    v3 extents(0.0f);
+    for (i32 i = 0; i < 3; ++i)
+      extents += abs(rotation_matrix[i]) * size[i];
+    return AABBCollider(position, extents);
+  }
+
   bool Plane::PointInside(const v3 &point) const {
     f64 d = dot(point, normal);
     return epsilonEqual(d - distance, 0.0, std::numeric_limits<f64>::epsilon());
@@ -387,6 +406,34 @@ namespace axl {
     return point - normal * (f32)dist;
   }
 
+  Frustum Frustum::FromMatrix(const m4 &view_projection) {
+    // Gribb-Hartmann, every clip plane is the last row plus or minus one of the others
+    v4 row[4];
+    for (i32 i = 0; i < 4; ++i)
+      row[i] = v4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+
+    const v4 equations[6] = { row[3] + row[0], row[3] - row[0], row[3] + row[1],
+                              row[3] - row[1], row[3] + row[2], row[3] - row[2] };
+
+    Frustum frustum;
+    for (i32 i = 0; i < 6; ++i) {
+      v3 normal(equations[i]);
+      f32 inv_length = 1.0f / length(normal);
+      frustum.planes[i] = Plane(-equations[i].w * inv_length, normal * inv_length);
+    }
+    return frustum;
+  }
+
+  bool Frustum::AABBInside(const AABBCollider &aabb) const {
+    for (const Plane &plane : planes) {
+      // Outside once even the corner furthest along the normal is behind the plane
+      f64 radius = dot(abs(plane.normal), abs(aabb.size));
+      if (plane.PlaneEquation(aabb.position) < -radius)
+        return false;
+    }
+    return true;
+  }
+
   bool Ray::PointInside(const v3 &point) const {
     if (point == position)
       return true;
@@ -450,8 +497,8 @@ namespace axl {
     return SphereOBBCollide(other, *this);
   }
 
-  std::vector<v3> OBBCollider::GetVertices() const {
-    std::vector<v3> v(8);
+  std::array<v3, 8> OBBCollider::GetVertices() const {
+    std::array<v3, 8> v;
 
     v[0] = position + rotation_matrix[0] * size[0] + rotation_matrix[1] * size[1] + rotation_matrix[2] * size[2];
     v[1] = position - rotation_matrix[0] * size[0] + rotation_matrix[1] * size[1] + rotation_matrix[2] * size[2];
@@ -465,153 +512,280 @@ namespace axl {
     return v;
   }
 
-  std::vector<Line> OBBCollider::GetEdges() const {
-    std::vector<Line> e(12);
-    std::vector<v3> v = GetVertices();
-
-    i32 index[][2] = { { 6, 1 }, { 6, 3 }, { 6, 4 }, { 2, 7 }, { 2, 5 }, { 2, 0 },
-                       { 0, 1 }, { 0, 3 }, { 7, 1 }, { 7, 4 }, { 4, 5 }, { 5, 3 } };
-
-    for (i32 i = 0; i < 12; i++)
-      e.push_back(Line(v[index[i][0]], v[index[i][1]]));
-
-    return e;
+  // Sutherland-Hodgman against one plane, keeps the side where dot(normal, point) <= distance. A convex polygon
+  // gains at most one vertex per plane.
+  template<u32 Capacity>
+  static void ClipPolygon(const FixedVector<v3, Capacity> &polygon, const v3 &normal, f32 distance,
+                          FixedVector<v3, Capacity> &out_polygon) {
+    out_polygon.clear();
+    if (polygon.empty())
+      return;
+
+    v3 a = polygon[polygon.size() - 1];
+    f32 a_dist = dot(normal, a) - distance;
+    for (const v3 &b : polygon) {
+      f32 b_dist = dot(normal, b) - distance;
+      if ((a_dist <= 0.0f) != (b_dist <= 0.0f) && !out_polygon.full())
+        out_polygon.push_back(a + (b - a) * (a_dist / (a_dist - b_dist)));
+      if (b_dist <= 0.0f && !out_polygon.full())
+        out_polygon.push_back(b);
+
+      a = b;
+      a_dist = b_dist;
+    }
   }
 
-  std::vector<Plane> OBBCollider::GetPlanes() const {
-    std::vector<Plane> p(6);
-
-    p[0] = Plane(dot(rotation_matrix[0], (position + rotation_matrix[0] * size[0])), rotation_matrix[0]);
-    p[1] = Plane(-dot(rotation_matrix[0], (position - rotation_matrix[0] * size[0])), rotation_matrix[0] * -1.0f);
-    p[2] = Plane(dot(rotation_matrix[1], (position + rotation_matrix[1] * size[1])), rotation_matrix[1]);
-    p[3] = Plane(-dot(rotation_matrix[1], (position - rotation_matrix[1] * size[1])), rotation_matrix[1] * -1.0f);
-    p[4] = Plane(dot(rotation_matrix[2], (position + rotation_matrix[2] * size[2])), rotation_matrix[2]);
-    p[5] = Plane(-dot(rotation_matrix[2], (position - rotation_matrix[2] * size[2])), rotation_matrix[2] * -1.0f);
-
-    return p;
-  }
+  // Clips the incident face, the face of incident most opposed to normal, against the side planes of the reference
+  // face. normal is the outward normal of that face, reference axis face_axis. Points are placed halfway between
+  // both surfaces.
+  static void ClipIncidentFace(const OBBCollider &reference, const OBBCollider &incident, i32 face_axis,
+                               const v3 &normal, FixedVector<v3, 8> &out_points) {
+    const m3 &ref_axes = reference.GetRotationMatrix();
+    const m3 &inc_axes = incident.GetRotationMatrix();
+
+    i32 inc_axis = 0;
+    f32 inc_dot = dot(normal, inc_axes[0]);
+    for (i32 i = 1; i < 3; ++i) {
+      f32 d = dot(normal, inc_axes[i]);
+      if (abs(d) > abs(inc_dot)) {
+        inc_dot = d;
+        inc_axis = i;
+      }
+    }
 
-  bool OBBCollider::ClipToPlane(const Plane &plane, const Line &line, v3 &out_point) const {
-    v3 ab = line.end - line.start;
-    f64 d_ab = dot(plane.normal, ab);
+    v3 inc_center = incident.position - inc_axes[inc_axis] * (incident.size[inc_axis] * sign(inc_dot));
+    v3 u = inc_axes[(inc_axis + 1) % 3] * incident.size[(inc_axis + 1) % 3];
+    v3 v = inc_axes[(inc_axis + 2) % 3] * incident.size[(inc_axis + 2) % 3];
 
-    if (epsilonEqual(d_ab, 0.0, std::numeric_limits<f64>::epsilon()))
-      return false;
+    FixedVector<v3, 8> polygon;
+    FixedVector<v3, 8> clipped;
+    polygon.push_back(inc_center + u + v);
+    polygon.push_back(inc_center - u + v);
+    polygon.push_back(inc_center - u - v);
+    polygon.push_back(inc_center + u - v);
 
-    f64 d_a = dot(plane.normal, line.start);
-    f64 t = (plane.distance - d_a) / d_ab;
+    for (i32 i = 1; i < 3; ++i) {
+      i32 side = (face_axis + i) % 3;
+      const v3 &side_normal = ref_axes[side];
+      f32 center = dot(side_normal, reference.position);
 
-    if (t >= 0.0 && t <= 1.0) {
-      out_point = line.start + ab * (f32)t;
-      return true;
+      ClipPolygon(polygon, side_normal, center + reference.size[side], clipped);
+      ClipPolygon(clipped, -side_normal, -center + reference.size[side], polygon);
     }
 
-    return false;
+    f32 face_distance = dot(normal, reference.position) + reference.size[face_axis];
+    out_points.clear();
+    for (const v3 &point : polygon) {
+      f32 separation = dot(normal, point) - face_distance;
+      if (separation <= 0.0f)
+        out_points.push_back(point - normal * (separation * 0.5f));
+    }
   }
 
-  std::vector<v3> OBBCollider::ClipEdgesToOBB(const std::vector<Line> &edges) const {
-    std::vector<v3> result;
-    result.reserve(edges.size());
-    std::vector<Plane> planes = GetPlanes();
-    v3 intersection;
+  // Closest points between the two edges that realise the separating axis, each one being the edge of its box
+  // furthest along normal towards the other box
+  static v3 EdgeContact(const OBBCollider &a, const OBBCollider &b, i32 a_axis, i32 b_axis, const v3 &normal) {
+    const m3 &a_axes = a.GetRotationMatrix();
+    const m3 &b_axes = b.GetRotationMatrix();
 
-    for (i32 i = 0; i < planes.size(); ++i) {
-      for (i32 j = 0; j < edges.size(); ++j) {
-        if (!ClipToPlane(planes[i], edges[j], intersection))
-          continue;
-        if (!PointInside(intersection))
-          continue;
-
-        result.push_back(intersection);
-      }
+    v3 a_point = a.position;
+    v3 b_point = b.position;
+    for (i32 i = 0; i < 3; ++i) {
+      if (i != a_axis)
+        a_point += a_axes[i] * (a.size[i] * sign(dot(a_axes[i], normal)));
+      if (i != b_axis)
+        b_point -= b_axes[i] * (b.size[i] * sign(dot(b_axes[i], normal)));
     }
 
-    return result;
-  }
-
-  f64 OBBCollider::PenetrationDepth(const OBBCollider &obb, const v3 &axis, bool &out_should_flip) const {
-    Interval ia = GetInterval(normalize(axis));
-    Interval ib = obb.GetInterval(normalize(axis));
-
-    if (!((ib.min <= ia.max) && (ia.min <= ib.max)))
-      return 0.0;
+    const v3 &a_dir = a_axes[a_axis];
+    const v3 &b_dir = b_axes[b_axis];
+    v3 r = a_point - b_point;
+    f32 d = dot(a_dir, b_dir);
+    f32 c = dot(a_dir, r);
+    f32 f = dot(b_dir, r);
+    f32 denom = 1.0f - d * d;
+
+    f32 s = denom > std::numeric_limits<f32>::epsilon() ? (d * f - c) / denom : 0.0f;
+    s = clamp(s, -a.size[a_axis], a.size[a_axis]);
+    f32 t = clamp(d * s + f, -b.size[b_axis], b.size[b_axis]);
+
+    return (a_point + a_dir * s + b_point + b_dir * t) * 0.5f;
+  }
+
+  // Keeps the MANIFOLD_MAX_POINTS points spanning the largest area on the contact plane: the extreme point along a
+  // tangent, the one farthest from it, the one making the largest triangle with both, then the one adding the most
+  // area outside of that triangle.
+  template<u32 Capacity>
+  static void ReduceContactPoints(const FixedVector<v3, Capacity> &points, const v3 &normal,
+                                  FixedVector<v3, MANIFOLD_MAX_POINTS> &out_points) {
+    out_points.clear();
+    if (points.size() <= MANIFOLD_MAX_POINTS) {
+      for (const v3 &point : points)
+        out_points.push_back(point);
+      return;
+    }
 
-    f64 len_a = ia.max - ia.min;
-    f64 len_b = ib.max - ib.min;
-    f64 i_min = min(ia.min, ib.min);
-    f64 i_max = max(ia.max, ib.max);
-    f64 len = i_max - i_min;
+    v3 tangent = abs(normal.x) >= 0.57735f ? v3(normal.y, -normal.x, 0.0f) : v3(0.0f, normal.z, -normal.y);
+
+    u32 a = 0;
+    for (u32 i = 1; i < points.size(); ++i)
+      if (dot(points[i], tangent) > dot(points[a], tangent))
+        a = i;
+
+    u32 b = a;
+    for (u32 i = 0; i < points.size(); ++i)
+      if (distance2(points[i], points[a]) > distance2(points[b], points[a]))
+        b = i;
+
+    u32 c = a;
+    f32 c_area = 0.0f;
+    for (u32 i = 0; i < points.size(); ++i) {
+      f32 area = dot(cross(points[b] - points[a], points[i] - points[a]), normal);
+      if (abs(area) > abs(c_area)) {
+        c_area = area;
+        c = i;
+      }
+    }
 
-    out_should_flip = ib.min < ia.min;
+    // Wind a, b, c counter clockwise around the normal, so outside of an edge means negative area
+    if (c_area < 0.0f)
+      std::swap(a, b);
+
+    u32 d = a;
+    f32 d_area = 0.0f;
+    for (u32 i = 0; i < points.size(); ++i) {
+      f32 area = min(dot(cross(points[b] - points[a], points[i] - points[a]), normal),
+                     min(dot(cross(points[c] - points[b], points[i] - points[b]), normal),
+                         dot(cross(points[a] - points[c], points[i] - points[c]), normal)));
+      if (area < d_area) {
+        d_area = area;
+        d = i;
+      }
+    }
 
-    return (len_a + len_b) - len;
+    out_points.push_back(points[a]);
+    out_points.push_back(points[b]);
+    if (c != a && c != b)
+      out_points.push_back(points[c]);
+    if (d != a && d != b && d != c)
+      out_points.push_back(points[d]);
   }
 
+  // Gottschalk's separating axis test. Every axis is projected from the rotation between both boxes, computed once,
+  // and the test returns as soon as one separates them. Face axes are preferred over edge axes unless an edge axis is
+  // clearly shallower, which keeps resting boxes on stable face contacts.
   CollisionManifold OBBCollider::OBBCollide(const OBBCollider &other) const {
     CollisionManifold result;
 
-    std::array<v3, 15> test;
-    test[0] = v3(rotation_matrix[0][0], rotation_matrix[0][1], rotation_matrix[0][2]);
-    test[1] = v3(rotation_matrix[1][0], rotation_matrix[1][1], rotation_matrix[1][2]);
-    test[2] = v3(rotation_matrix[2][0], rotation_matrix[2][1], rotation_matrix[2][2]);
-    test[3] = v3(other.rotation_matrix[0][0], other.rotation_matrix[0][1], other.rotation_matrix[0][2]);
-    test[4] = v3(other.rotation_matrix[1][0], other.rotation_matrix[1][1], other.rotation_matrix[1][2]);
-    test[5] = v3(other.rotation_matrix[2][0], other.rotation_matrix[2][1], other.rotation_matrix[2][2]);
+    const m3 &a = rotation_matrix;
+    const m3 &b = other.rotation_matrix;
+    const v3 &ea = size;
+    const v3 &eb = other.size;
 
+    m3 r;
+    m3 abs_r;
     for (i32 i = 0; i < 3; ++i) {
-      test[6 + i * 3 + 0] = cross(test[i], test[0]);
-      test[6 + i * 3 + 1] = cross(test[i], test[1]);
-      test[6 + i * 3 + 2] = cross(test[i], test[2]);
+      for (i32 j = 0; j < 3; ++j) {
+        r[i][j] = dot(a[i], b[j]);
+        abs_r[i][j] = abs(r[i][j]) + OBB_PARALLEL_EPSILON;
+      }
     }
 
-    std::optional<v3> hit_point;
-    bool should_flip = false;
+    v3 t_world = other.position - position;
+    v3 t(dot(t_world, a[0]), dot(t_world, a[1]), dot(t_world, a[2]));
 
-    for (i32 i = 0; i < 15; ++i) {
-      if (length2(test[i]) < std::numeric_limits<f32>::epsilon())
-        continue;
+    f32 face_depth = std::numeric_limits<f32>::max();
+    i32 face_axis = 0;
+    bool face_on_a = true;
 
-      f64 depth = PenetrationDepth(other, test[i], should_flip);
-      if (depth < std::numeric_limits<f64>::epsilon()) {
+    for (i32 i = 0; i < 3; ++i) {
+      f32 rb = eb[0] * abs_r[i][0] + eb[1] * abs_r[i][1] + eb[2] * abs_r[i][2];
+      f32 depth = ea[i] + rb - abs(t[i]);
+      if (depth < 0.0f)
         return result;
-      } else if (depth < result.depth) {
-        if (should_flip)
-          test[i] = test[i] * -1.0f;
-        result.depth = depth;
-        hit_point = test[i];
+      if (depth < face_depth) {
+        face_depth = depth;
+        face_axis = i;
       }
     }
 
-    if (!hit_point)
-      return result;
-
-    v3 axis = normalize(*hit_point);
-    std::vector<v3> ca = ClipEdgesToOBB(other.GetEdges());
-    std::vector<v3> cb = other.ClipEdgesToOBB(GetEdges());
-
-    result.points.reserve(ca.size() + cb.size());
-    result.points.insert(result.points.end(), ca.begin(), ca.end());
-    result.points.insert(result.points.end(), cb.begin(), cb.end());
-
-    Interval i = GetInterval(axis);
-    f64 dist = (i.max - i.min) * 0.5f - result.depth * 0.5f;
-    v3 point_plane = position + axis * (f32)dist;
+    for (i32 j = 0; j < 3; ++j) {
+      f32 ra = ea[0] * abs_r[0][j] + ea[1] * abs_r[1][j] + ea[2] * abs_r[2][j];
+      f32 dist = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+      f32 depth = ra + eb[j] - abs(dist);
+      if (depth < 0.0f)
+        return result;
+      if (depth < face_depth * OBB_RELATIVE_TOLERANCE - OBB_ABSOLUTE_TOLERANCE) {
+        face_depth = depth;
+        face_axis = j;
+        face_on_a = false;
+      }
+    }
 
-    for (i32 i = result.points.size() - 1; i >= 0; --i) {
-      v3 contact = result.points[i];
-      result.points[i] = contact + (axis * dot(axis, point_plane - contact));
+    f32 edge_depth = std::numeric_limits<f32>::max();
+    i32 edge_a = -1;
+    i32 edge_b = -1;
 
-      for (i32 j = result.points.size() - 1; j >= 0; --j) {
-        if (length2(result.points[j] - result.points[i]) >= std::numeric_limits<f32>::epsilon())
+    for (i32 i = 0; i < 3; ++i) {
+      i32 i1 = (i + 1) % 3;
+      i32 i2 = (i + 2) % 3;
+      for (i32 j = 0; j < 3; ++j) {
+        i32 j1 = (j + 1) % 3;
+        i32 j2 = (j + 2) % 3;
+
+        f32 ra = ea[i1] * abs_r[i2][j] + ea[i2] * abs_r[i1][j];
+        f32 rb = eb[j1] * abs_r[i][j2] + eb[j2] * abs_r[i][j1];
+        f32 dist = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+        f32 depth = ra + rb - abs(dist);
+        if (depth < 0.0f)
+          return result;
+
+        // Only the separation test may use the padded projections, depths need the real axis length
+        f32 axis_length = sqrt(max(1.0f - r[i][j] * r[i][j], 0.0f));
+        if (axis_length < OBB_PARALLEL_EPSILON)
           continue;
 
-        result.points.erase(result.points.begin() + j);
-        break;
+        depth /= axis_length;
+        if (depth < edge_depth) {
+          edge_depth = depth;
+          edge_a = i;
+          edge_b = j;
+        }
       }
     }
 
     result.colliding = true;
-    result.normal = axis;
+
+    if (edge_a >= 0 && edge_depth < face_depth * OBB_RELATIVE_TOLERANCE - OBB_ABSOLUTE_TOLERANCE) {
+      v3 normal = normalize(cross(a[edge_a], b[edge_b]));
+      if (dot(normal, t_world) < 0.0f)
+        normal = -normal;
+
+      result.normal = normal;
+      result.depth = edge_depth;
+      result.points.push_back(EdgeContact(*this, other, edge_a, edge_b, normal));
+      return result;
+    }
+
+    // The normal always points from this box towards the other one, the reference face is on the box owning the axis
+    FixedVector<v3, 8> clipped;
+    if (face_on_a) {
+      v3 normal = dot(a[face_axis], t_world) < 0.0f ? -a[face_axis] : a[face_axis];
+      ClipIncidentFace(*this, other, face_axis, normal, clipped);
+      result.normal = normal;
+    } else {
+      v3 normal = dot(b[face_axis], t_world) > 0.0f ? -b[face_axis] : b[face_axis];
+      ClipIncidentFace(other, *this, face_axis, normal, clipped);
+      result.normal = -normal;
+    }
+    result.depth = face_depth;
+
+    if (clipped.empty()) {
+      result.colliding = false;
+      return result;
+    }
+
+    ReduceContactPoints(clipped, result.normal, result.points);
 
     return result;
   }
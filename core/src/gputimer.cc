@@ -0,0 +1,93 @@
+#include <axolotl/gputimer.hh>
+#include <glad.h>
+
+namespace axl {
+
+  GPUTimer::GPUTimer() {
+    for (Frame &frame : _frames)
+      glGenQueries(frame.queries.size(), frame.queries.data());
+  }
+
+  GPUTimer::~GPUTimer() {
+    for (Frame &frame : _frames)
+      glDeleteQueries(frame.queries.size(), frame.queries.data());
+  }
+
+  void GPUTimer::BeginFrame() {
+    Frame &frame = _frames[_frame_index % GPU_TIMER_FRAMES];
+    // Written GPU_TIMER_FRAMES frames ago, read it before its queries get reused
+    if (frame.pending)
+      Resolve(frame);
+
+    frame.scope_count = 0;
+    frame.pending = false;
+    _open_scopes.clear();
+    Begin("Frame");
+  }
+
+  void GPUTimer::EndFrame() {
+    while (!_open_scopes.empty())
+      End();
+
+    _frames[_frame_index % GPU_TIMER_FRAMES].pending = true;
+    _frame_index++;
+  }
+
+  void GPUTimer::Begin(const std::string &name) {
+    Frame &frame = _frames[_frame_index % GPU_TIMER_FRAMES];
+    if (frame.scope_count >= GPU_TIMER_MAX_SCOPES) {
+#ifdef AXOLOTL_DEBUG
+      log::warn("Too many GPU timer scopes, dropping {}", name);
+#endif
+      _open_scopes.push_back(GPU_TIMER_MAX_SCOPES);
+      return;
+    }
+
+    u32 scope = frame.scope_count++;
+    frame.names[scope] = name;
+    glQueryCounter(frame.queries[scope * 2], GL_TIMESTAMP);
+    _open_scopes.push_back(scope);
+  }
+
+  void GPUTimer::End() {
+    AXL_ASSERT_MESSAGE(!_open_scopes.empty(), "GPUTimer::End without a matching Begin");
+
+    u32 scope = _open_scopes.back();
+    _open_scopes.pop_back();
+    if (scope == GPU_TIMER_MAX_SCOPES)
+      return;
+
+    Frame &frame = _frames[_frame_index % GPU_TIMER_FRAMES];
+    glQueryCounter(frame.queries[scope * 2 + 1], GL_TIMESTAMP);
+  }
+
+  void GPUTimer::Resolve(Frame &frame) {
+    frame.pending = false;
+
+    // The frame query ends last, once it is available every other one is as well
+    i32 available = 0;
+    glGetQueryObjectiv(frame.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      return;
+
+    _scopes.resize(frame.scope_count);
+    for (u32 i = 0; i < frame.scope_count; ++i) {
+      u64 start_time, end_time;
+      glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start_time);
+      glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end_time);
+
+      _scopes[i].name = frame.names[i];
+      _scopes[i].time = (f64)(end_time - start_time) / 1000000.0;
+    }
+    _frame_time = _scopes.empty() ? 0.0 : _scopes[0].time;
+  }
+
+  f64 GPUTimer::GetFrameTime() const {
+    return _frame_time;
+  }
+
+  const std::vector<GPUTimer::Scope> &GPUTimer::GetScopes() const {
+    return _scopes;
+  }
+
+} // namespace axl
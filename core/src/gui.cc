@@ -3,6 +3,7 @@
 #include <IconsFontAwesome5Pro.h>
 #include <axolotl/axolotl.hh>
 #include <axolotl/gui.hh>
+#include <axolotl/renderstate.hh>
 #include <axolotl/window.hh>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -226,6 +227,8 @@ namespace axl {
   void GUI::Draw() {
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // The backend binds its own program, vao and textures without going through RenderState
+    RenderState::Invalidate();
 
     if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
       GLFWwindow *current_window = glfwGetCurrentContext();
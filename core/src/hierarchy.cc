@@ -0,0 +1,83 @@
+#include <axolotl/ento.hh>
+#include <axolotl/hierarchy.hh>
+#include <axolotl/lookup.hh>
+#include <axolotl/transform.hh>
+
+namespace axl {
+
+  void TransformHierarchy::Invalidate() {
+    _invalid = true;
+  }
+
+  u32 TransformHierarchy::GetUpdatedCount() const {
+    return _updated_count;
+  }
+
+  void TransformHierarchy::Rebuild(entt::registry &registry, const UUIDMap &ids) {
+    _entities.clear();
+    _parents.clear();
+
+    registry.view<Transform, HierarchyComponent>().each(
+      [&](entt::entity entity, Transform &transform, HierarchyComponent &hierarchy) {
+        if (hierarchy.parent.is_nil() || ids.Find(hierarchy.parent) == entt::null) {
+          _entities.push_back(entity);
+          _parents.push_back(-1);
+        }
+      });
+
+    // Breadth first, so every entity lands after its parent
+    for (size_t i = 0; i < _entities.size(); ++i) {
+      const HierarchyComponent &hierarchy = registry.get<HierarchyComponent>(_entities[i]);
+
+      for (const uuid &child_id : hierarchy.children) {
+        entt::entity child = ids.Find(child_id);
+        if (child == entt::null || !registry.all_of<Transform, HierarchyComponent>(child))
+          continue;
+        // Only follow links both sides agree on, keeps broken hierarchies from looping
+        if (ids.Find(registry.get<HierarchyComponent>(child).parent) != _entities[i])
+          continue;
+
+        _entities.push_back(child);
+        _parents.push_back((i32)i);
+      }
+    }
+
+    _world.resize(_entities.size());
+    _dirty.resize(_entities.size());
+  }
+
+  void TransformHierarchy::Update(entt::registry &registry, const UUIDMap &ids) {
+    bool force = _invalid;
+    if (_invalid) {
+      Rebuild(registry, ids);
+      _invalid = false;
+    }
+
+    _updated_count = 0;
+    for (size_t i = 0; i < _entities.size(); ++i) {
+      Transform &transform = registry.get<Transform>(_entities[i]);
+      i32 parent = _parents[i];
+
+      bool dirty = force || transform._is_dirty || (parent != -1 && _dirty[parent]);
+      _dirty[i] = dirty;
+      if (!dirty)
+        continue;
+
+      m4 model = transform.GetLocalMatrix();
+      if (parent != -1) {
+        transform._parent_model_matrix = _world[parent];
+        model = _world[parent] * model;
+      } else {
+        // Entities that were just unparented would otherwise keep their old parent's matrix
+        transform._parent_model_matrix = m4(1.0f);
+      }
+
+      _world[i] = model;
+      transform._model_matrix = model;
+      transform._is_dirty = false;
+      transform._was_dirty = true;
+      _updated_count++;
+    }
+  }
+
+} // namespace axl
@@ -0,0 +1,112 @@
+#include <axolotl/jobs.hh>
+
+namespace axl {
+
+  void JobSystem::Init(u32 thread_count) {
+    if (_running)
+      return;
+
+    if (thread_count == 0)
+      thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    _running = true;
+    for (u32 i = 1; i < thread_count; ++i)
+      _workers.emplace_back(WorkerLoop, i);
+
+    log::info("Job system started with {} threads", thread_count);
+  }
+
+  void JobSystem::Terminate() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _running = false;
+    }
+    _wake.notify_all();
+
+    for (std::thread &worker : _workers)
+      worker.join();
+    _workers.clear();
+  }
+
+  u32 JobSystem::GetThreadCount() {
+    return _workers.size() + 1;
+  }
+
+  void JobSystem::ParallelFor(u32 count, u32 chunk_size, const Job &job) {
+    if (count == 0)
+      return;
+
+    chunk_size = std::max(chunk_size, 1u);
+    u32 chunk_count = (count + chunk_size - 1) / chunk_size;
+
+    // Not worth waking anyone up
+    if (_workers.empty() || chunk_count == 1) {
+      for (u32 begin = 0; begin < count; begin += chunk_size)
+        job(begin, std::min(begin + chunk_size, count), 0);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      AXL_ASSERT_MESSAGE(_job == nullptr, "JobSystem::ParallelFor is not reentrant");
+
+      _job = &job;
+      _count = count;
+      _chunk_size = chunk_size;
+      _chunk_count = chunk_count;
+      _next_chunk = 0;
+      _remaining_chunks = chunk_count;
+      _generation++;
+    }
+    _wake.notify_all();
+
+    RunChunks(0);
+
+    // Wait for the chunks and for every worker to leave RunChunks, so the next dispatch starts clean
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [] { return _remaining_chunks == 0 && _busy_workers == 0; });
+    _job = nullptr;
+  }
+
+  void JobSystem::WorkerLoop(u32 thread_index) {
+    u64 generation = 0;
+
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [&] { return !_running || (_job && _generation != generation); });
+        if (!_running)
+          return;
+
+        generation = _generation;
+        _busy_workers++;
+      }
+
+      RunChunks(thread_index);
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _busy_workers--;
+      }
+      _done.notify_all();
+    }
+  }
+
+  void JobSystem::RunChunks(u32 thread_index) {
+    while (true) {
+      u32 chunk = _next_chunk.fetch_add(1);
+      if (chunk >= _chunk_count)
+        return;
+
+      u32 begin = chunk * _chunk_size;
+      u32 end = std::min(begin + _chunk_size, _count);
+      (*_job)(begin, end, thread_index);
+
+      if (_remaining_chunks.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done.notify_all();
+      }
+    }
+  }
+
+} // namespace axl
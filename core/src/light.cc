@@ -4,9 +4,13 @@
 
 namespace axl {
 
-  Light::Light(): color(v4(1.0f)), intensity(1.0f), type(LightType::Directional) { }
+  Light::Light(): color(v4(1.0f)), intensity(1.0f), type(LightType::Directional), range(10.0f) { }
 
-  Light::Light(LightType type, v3 color, f32 intensity): color(v4(color, 1.0f)), intensity(intensity), type(type) { }
+  Light::Light(LightType type, v3 color, f32 intensity):
+    color(v4(color, 1.0f)),
+    intensity(intensity),
+    type(type),
+    range(10.0f) { }
 
   void Light::Init() { }
 
@@ -60,6 +64,8 @@ namespace axl {
       modified = true;
     if (ShowData("Intensity", intensity))
       modified = true;
+    if (ShowData("Range", range))
+      modified = true;
 
     return modified;
   }
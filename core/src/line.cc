@@ -1,4 +1,5 @@
 #include <axolotl/line.hh>
+#include <axolotl/renderstate.hh>
 #include <glad.h>
 
 namespace axl {
@@ -87,6 +88,7 @@ namespace axl {
   }
 
   LinePrimitive::~LinePrimitive() {
+    RenderState::ForgetVertexArray(_vao);
     glDeleteVertexArrays(1, &_vao);
     glDeleteBuffers(1, &_vbo);
   }
@@ -98,7 +100,7 @@ namespace axl {
   }
 
   void LinePrimitive::LoadBuffers() {
-    glBindVertexArray(_vao);
+    RenderState::BindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
 
     glBufferData(GL_ARRAY_BUFFER, sizeof(LineVertex) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
@@ -113,20 +115,18 @@ namespace axl {
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void *)(sizeof(v3)));
 
-    glBindVertexArray(0);
+    RenderState::BindVertexArray(0);
   }
 
   void LinePrimitive::Draw() const {
     glLineWidth(thickness);
 
-    glBindVertexArray(_vao);
+    RenderState::BindVertexArray(_vao);
 
     if (!_indices.empty())
       glDrawElements(GL_LINES, _indices.size() * 2, GL_UNSIGNED_INT, 0);
     else
       glDrawArrays(loop ? GL_LINE_LOOP : GL_LINE_STRIP, 0, _vertices.size());
-
-    glBindVertexArray(0);
   }
 
   void LinePrimitive::SetColor(const Color &color) {
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <axolotl/lookup.hh>
+#include <cstring>
+
+namespace axl {
+
+  constexpr u32 UUID_MAP_MIN_CAPACITY = 64;
+
+  void HandleIndex::Insert(entt::entity handle, const uuid &id) {
+    auto index = entt::to_entity(handle);
+    if (index >= _slots.size())
+      _slots.resize(std::max<size_t>(index + 1, _slots.size() * 2));
+
+    _slots[index].handle = handle;
+    _slots[index].id = id;
+  }
+
+  void HandleIndex::Erase(entt::entity handle) {
+    auto index = entt::to_entity(handle);
+    if (index >= _slots.size() || _slots[index].handle != handle)
+      return;
+
+    _slots[index] = Slot();
+  }
+
+  void HandleIndex::Clear() {
+    _slots.clear();
+  }
+
+  u64 UUIDMap::Hash(const uuid &id) {
+    auto bytes = id.as_bytes();
+    u64 lo;
+    u64 hi;
+    std::memcpy(&lo, bytes.data(), sizeof(u64));
+    std::memcpy(&hi, bytes.data() + sizeof(u64), sizeof(u64));
+
+    // Ids loaded from disk are not guaranteed to be random, mix them anyway (splitmix64 finalizer)
+    u64 x = lo ^ (hi * 0x9e3779b97f4a7c15ull);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  void UUIDMap::Grow() {
+    std::vector<Slot> old_slots;
+    old_slots.swap(_slots);
+    _slots.resize(std::max<size_t>(old_slots.size() * 2, UUID_MAP_MIN_CAPACITY));
+    _size = 0;
+
+    for (const Slot &slot : old_slots)
+      if (!slot.id.is_nil())
+        Insert(slot.id, slot.handle);
+  }
+
+  void UUIDMap::Insert(const uuid &id, entt::entity handle) {
+    AXL_ASSERT_MESSAGE(!id.is_nil(), "Trying to index a nil uuid");
+
+    // Keep the load factor under 0.75
+    if ((_size + 1) * 4 > _slots.size() * 3)
+      Grow();
+
+    size_t mask = _slots.size() - 1;
+    size_t i = Hash(id) & mask;
+    while (!_slots[i].id.is_nil()) {
+      if (_slots[i].id == id) {
+        _slots[i].handle = handle;
+        return;
+      }
+      i = (i + 1) & mask;
+    }
+
+    _slots[i].id = id;
+    _slots[i].handle = handle;
+    _size++;
+  }
+
+  void UUIDMap::Erase(const uuid &id) {
+    if (_slots.empty() || id.is_nil())
+      return;
+
+    size_t mask = _slots.size() - 1;
+    size_t i = Hash(id) & mask;
+    while (_slots[i].id != id) {
+      if (_slots[i].id.is_nil())
+        return;
+      i = (i + 1) & mask;
+    }
+
+    // Shift the following entries of the cluster back, so lookups never need tombstones
+    size_t hole = i;
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask;
+      if (_slots[j].id.is_nil())
+        break;
+
+      size_t home = Hash(_slots[j].id) & mask;
+      // Move j into the hole only if its home is not in the cyclic range (hole, j]
+      bool in_range = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+      if (in_range)
+        continue;
+
+      _slots[hole] = _slots[j];
+      hole = j;
+    }
+
+    _slots[hole] = Slot();
+    _size--;
+  }
+
+  void UUIDMap::Clear() {
+    _slots.clear();
+    _size = 0;
+  }
+
+  u32 UUIDMap::Size() const {
+    return _size;
+  }
+
+  entt::entity UUIDMap::Find(const uuid &id) const {
+    if (_slots.empty() || id.is_nil())
+      return entt::null;
+
+    size_t mask = _slots.size() - 1;
+    size_t i = Hash(id) & mask;
+    while (!_slots[i].id.is_nil()) {
+      if (_slots[i].id == id)
+        return _slots[i].handle;
+      i = (i + 1) & mask;
+    }
+
+    return entt::null;
+  }
+
+} // namespace axl
@@ -6,6 +6,7 @@
 namespace axl {
 
   Material::Material(const std::vector<std::string> &paths):
+    _sort_id(++_sort_id_counter),
     _textures(std::array<Texture2D, (i32)TextureType::Last>()) {
 
     std::fill(_textures.begin(), _textures.end(), Texture2D());
@@ -28,6 +29,11 @@ namespace axl {
 
   void Material::BindAll() {
     _shader->Bind();
+    BindTextures();
+  }
+
+  // Expects the material's shader to be bound already
+  void Material::BindTextures() {
     for (i32 i = 1; i < (i32)TextureType::Last; ++i) {
       Bind(i, (TextureType)i);
     }
@@ -66,6 +72,10 @@ namespace axl {
     return *_shader;
   }
 
+  u32 Material::GetSortID() const {
+    return _sort_id;
+  }
+
   json Material::Serialize() const {
     json j;
     return j;
@@ -1,4 +1,6 @@
 #include <axolotl/mesh.hh>
+#include <axolotl/renderstate.hh>
+#include <axolotl/shader.hh>
 #include <glad.h>
 
 namespace axl {
@@ -7,7 +9,10 @@ namespace axl {
     _vao(0),
     _num_vertices(0),
     _num_indices(0),
-    _single_mesh(true) {
+    _single_mesh(true),
+    _has_bounds(false),
+    _bounds_min(0.0f),
+    _bounds_max(0.0f) {
     _num_vertices = vertices.size() / 11;
     _num_indices = indices.size();
 
@@ -17,7 +22,7 @@ namespace axl {
   void Mesh::LoadBuffers(const std::vector<f32> &vertices, const std::vector<u32> &indices) {
     log::debug("Creating mesh with {} vertices and {} indices", _num_vertices, _num_indices);
     glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
+    RenderState::BindVertexArray(_vao);
 
     u32 vbo = 0;
     glGenBuffers(1, &vbo);
@@ -46,7 +51,7 @@ namespace axl {
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 11 * sizeof(f32), (void *)(9 * sizeof(f32)));
 
-    glBindVertexArray(0);
+    RenderState::BindVertexArray(0);
 
     log::debug("Mesh created {}", _vao);
   }
@@ -56,6 +61,7 @@ namespace axl {
     log::debug("Deleting mesh {}", _vao);
     for (auto &buffer : _buffers)
       glDeleteBuffers(1, &buffer.vbo);
+    RenderState::ForgetVertexArray(_vao);
     glDeleteVertexArrays(1, &_vao);
   }
 
@@ -67,12 +73,24 @@ namespace axl {
     return _material_id;
   }
 
+  // The vao stays bound after drawing, everything binding one goes through RenderState
   void Mesh::Draw() {
-    glBindVertexArray(_vao);
-    if (_num_indices > 0) glDrawElements(GL_TRIANGLES, _num_indices, GL_UNSIGNED_INT, 0);
+    RenderState::BindVertexArray(_vao);
+    if (_num_indices > 0)
+      glDrawElements(GL_TRIANGLES, _num_indices, GL_UNSIGNED_INT, 0);
     else
       glDrawArrays(GL_TRIANGLES, 0, _num_vertices);
-    glBindVertexArray(0);
+
+    _draw_calls++;
+  }
+
+  void Mesh::DrawInstanced(u32 first, u32 count) {
+    RenderState::BindVertexArray(_vao);
+
+    if (_num_indices > 0)
+      glDrawElementsInstancedBaseInstance(GL_TRIANGLES, _num_indices, GL_UNSIGNED_INT, 0, count, first);
+    else
+      glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, _num_vertices, count, first);
 
     _draw_calls++;
   }
@@ -64,7 +64,11 @@ namespace axl {
     aiVector3D scale, position;
     aiQuaternion rotation;
     scene->mRootNode->mTransformation.Decompose(scale, rotation, position);
-    ProcessNode(ento, *this, scene->mRootNode, scene);
+
+    std::string node_key = _path.string();
+    for (const std::string &shader_path : _shader_paths)
+      node_key += "|" + shader_path;
+    ProcessNode(ento, *this, scene->mRootNode, scene, node_key);
     TextureStore::ProcessQueue();
   }
 
@@ -110,7 +114,15 @@ namespace axl {
     std::vector<f32> buffer_data;
     std::vector<u32> indices;
 
+    // Bounds are gathered here once, the renderer culls against them every frame
+    v3 bounds_min(std::numeric_limits<f32>::max());
+    v3 bounds_max(std::numeric_limits<f32>::lowest());
+
     for (u32 i = 0; i < mesh->mNumVertices; i++) {
+      v3 vertex(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+      bounds_min = glm::min(bounds_min, vertex);
+      bounds_max = glm::max(bounds_max, vertex);
+
       buffer_data.push_back(mesh->mVertices[i].x);
       buffer_data.push_back(mesh->mVertices[i].y);
       buffer_data.push_back(mesh->mVertices[i].z);
@@ -154,23 +166,39 @@ namespace axl {
     ProcessMaterialTextures(mesh->mMaterialIndex, model, material, aiTextureType_HEIGHT);
 
     Mesh *result = new Mesh(buffer_data, indices);
+    if (mesh->mNumVertices > 0) {
+      result->_has_bounds = true;
+      result->_bounds_min = bounds_min;
+      result->_bounds_max = bounds_max;
+    }
 
     return result;
   }
 
-  void Model::ProcessNode(Ento ento, Model &model, aiNode *node, const aiScene *scene) {
+  void Model::ProcessNode(Ento ento, Model &model, aiNode *node, const aiScene *scene, const std::string &node_key) {
     if (ento.Tag().value == Tag::DefaultTag)
       ento.Tag().value = node->mName.C_Str();
 
-    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-      aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-      Mesh *m = ProcessMesh(ento, model, mesh, scene);
-
-      if (node->mNumMeshes > 1)
-        m->_single_mesh = false;
+    SharedNode &shared = _shared_nodes[node_key];
+    auto meshes = shared.meshes.lock();
+    auto materials = shared.materials.lock();
+    if (meshes && materials) {
+      model._meshes = meshes;
+      model._materials = materials;
+    } else {
+      for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+        Mesh *m = ProcessMesh(ento, model, mesh, scene);
+
+        if (node->mNumMeshes > 1)
+          m->_single_mesh = false;
+
+        model._meshes->push_back(m);
+        m->SetMaterialID(mesh->mMaterialIndex);
+      }
 
-      model._meshes->push_back(m);
-      m->SetMaterialID(mesh->mMaterialIndex);
+      shared.meshes = model._meshes;
+      shared.materials = model._materials;
     }
 
     for (u32 i = 0; i < node->mNumChildren; i++) {
@@ -211,7 +239,7 @@ namespace axl {
       }
 
       log::debug("Processing node {}", node->mName.C_Str());
-      ProcessNode(child, child_model, node->mChildren[i], scene);
+      ProcessNode(child, child_model, node->mChildren[i], scene, node_key + "/" + std::to_string(i));
     }
   }
 
@@ -0,0 +1,288 @@
+#include <axolotl/packet.hh>
+#include <axolotl/simd.hh>
+
+namespace axl {
+
+  static u32 LaneMask(u32 count) {
+    return (1u << count) - 1;
+  }
+
+  // Zero directions are nudged like the scalar test does, so the slabs never turn into 0 * inf
+  static v3 InverseDirection(const v3 &direction) {
+    v3 inv;
+    for (i32 axis = 0; axis < 3; ++axis) {
+      f32 d = direction[axis];
+      if (d == 0.0f)
+        d = std::numeric_limits<f32>::epsilon();
+      inv[axis] = 1.0f / d;
+    }
+    return inv;
+  }
+
+  AABBPacket::AABBPacket() {
+    for (i32 axis = 0; axis < 3; ++axis) {
+      for (u32 i = 0; i < GEOMETRY_PACKET_SIZE; ++i) {
+        min[axis][i] = 0.0f;
+        max[axis][i] = 0.0f;
+      }
+    }
+  }
+
+  void AABBPacket::Set(u32 index, const AABBCollider &aabb) {
+    AXL_ASSERT_MESSAGE(index < GEOMETRY_PACKET_SIZE, "AABBPacket index out of range");
+    v3 aabb_min = aabb.GetMin();
+    v3 aabb_max = aabb.GetMax();
+    for (i32 axis = 0; axis < 3; ++axis) {
+      min[axis][index] = aabb_min[axis];
+      max[axis][index] = aabb_max[axis];
+    }
+    count = std::max(count, index + 1);
+  }
+
+  u32 AABBPacket::AABBInside(const AABBCollider &aabb) const {
+    v3 other_min = aabb.GetMin();
+    v3 other_max = aabb.GetMax();
+    u32 mask = 0;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    for (; i + 8 <= GEOMETRY_PACKET_SIZE; i += 8) {
+      __m256 overlap = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m256 below = _mm256_cmp_ps(_mm256_load_ps(min[axis] + i), _mm256_set1_ps(other_max[axis]), _CMP_LE_OQ);
+        __m256 above = _mm256_cmp_ps(_mm256_load_ps(max[axis] + i), _mm256_set1_ps(other_min[axis]), _CMP_GE_OQ);
+        overlap = _mm256_and_ps(overlap, _mm256_and_ps(below, above));
+      }
+      mask |= (u32)_mm256_movemask_ps(overlap) << i;
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    for (; i + 4 <= GEOMETRY_PACKET_SIZE; i += 4) {
+      __m128 overlap = _mm_castsi128_ps(_mm_set1_epi32(-1));
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m128 below = _mm_cmple_ps(_mm_load_ps(min[axis] + i), _mm_set1_ps(other_max[axis]));
+        __m128 above = _mm_cmpge_ps(_mm_load_ps(max[axis] + i), _mm_set1_ps(other_min[axis]));
+        overlap = _mm_and_ps(overlap, _mm_and_ps(below, above));
+      }
+      mask |= (u32)_mm_movemask_ps(overlap) << i;
+    }
+#endif
+
+    for (; i < GEOMETRY_PACKET_SIZE; ++i) {
+      bool overlap = true;
+      for (i32 axis = 0; axis < 3; ++axis)
+        overlap &= min[axis][i] <= other_max[axis] && max[axis][i] >= other_min[axis];
+      mask |= (u32)overlap << i;
+    }
+
+    return mask & LaneMask(count);
+  }
+
+  u32 AABBPacket::RayInside(const Ray &ray, f32 *out_distances) const {
+    v3 inv = InverseDirection(ray.GetDirection());
+    u32 mask = 0;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    for (; i + 8 <= GEOMETRY_PACKET_SIZE; i += 8) {
+      __m256 t_min = _mm256_set1_ps(-std::numeric_limits<f32>::max());
+      __m256 t_max = _mm256_set1_ps(std::numeric_limits<f32>::max());
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m256 origin = _mm256_set1_ps(ray.position[axis]);
+        __m256 inv_8 = _mm256_set1_ps(inv[axis]);
+        __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(min[axis] + i), origin), inv_8);
+        __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(max[axis] + i), origin), inv_8);
+        t_min = _mm256_max_ps(t_min, _mm256_min_ps(t0, t1));
+        t_max = _mm256_min_ps(t_max, _mm256_max_ps(t0, t1));
+      }
+
+      __m256 hit = _mm256_and_ps(_mm256_cmp_ps(t_min, t_max, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(t_max, _mm256_setzero_ps(), _CMP_GE_OQ));
+      // Origins inside a box report where the ray leaves it
+      __m256 inside = _mm256_cmp_ps(t_min, _mm256_setzero_ps(), _CMP_LT_OQ);
+      __m256 distance = _mm256_blendv_ps(t_min, t_max, inside);
+      _mm256_storeu_ps(out_distances + i, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), distance, hit));
+      mask |= (u32)_mm256_movemask_ps(hit) << i;
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    for (; i + 4 <= GEOMETRY_PACKET_SIZE; i += 4) {
+      __m128 t_min = _mm_set1_ps(-std::numeric_limits<f32>::max());
+      __m128 t_max = _mm_set1_ps(std::numeric_limits<f32>::max());
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m128 origin = _mm_set1_ps(ray.position[axis]);
+        __m128 inv_4 = _mm_set1_ps(inv[axis]);
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min[axis] + i), origin), inv_4);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max[axis] + i), origin), inv_4);
+        t_min = _mm_max_ps(t_min, _mm_min_ps(t0, t1));
+        t_max = _mm_min_ps(t_max, _mm_max_ps(t0, t1));
+      }
+
+      __m128 hit = _mm_and_ps(_mm_cmple_ps(t_min, t_max), _mm_cmpge_ps(t_max, _mm_setzero_ps()));
+      // SSE2 has no blend, select through the comparison masks
+      __m128 inside = _mm_cmplt_ps(t_min, _mm_setzero_ps());
+      __m128 distance = _mm_or_ps(_mm_and_ps(inside, t_max), _mm_andnot_ps(inside, t_min));
+      distance = _mm_or_ps(_mm_and_ps(hit, distance), _mm_andnot_ps(hit, _mm_set1_ps(-1.0f)));
+      _mm_storeu_ps(out_distances + i, distance);
+      mask |= (u32)_mm_movemask_ps(hit) << i;
+    }
+#endif
+
+    for (; i < GEOMETRY_PACKET_SIZE; ++i) {
+      f32 t_min = -std::numeric_limits<f32>::max();
+      f32 t_max = std::numeric_limits<f32>::max();
+      for (i32 axis = 0; axis < 3; ++axis) {
+        f32 t0 = (min[axis][i] - ray.position[axis]) * inv[axis];
+        f32 t1 = (max[axis][i] - ray.position[axis]) * inv[axis];
+        t_min = std::max(t_min, std::min(t0, t1));
+        t_max = std::min(t_max, std::max(t0, t1));
+      }
+
+      bool hit = t_min <= t_max && t_max >= 0.0f;
+      out_distances[i] = hit ? (t_min < 0.0f ? t_max : t_min) : -1.0f;
+      mask |= (u32)hit << i;
+    }
+
+    return mask & LaneMask(count);
+  }
+
+  SpherePacket::SpherePacket() {
+    for (u32 i = 0; i < GEOMETRY_PACKET_SIZE; ++i) {
+      position[0][i] = 0.0f;
+      position[1][i] = 0.0f;
+      position[2][i] = 0.0f;
+      radius[i] = 0.0f;
+    }
+  }
+
+  void SpherePacket::Set(u32 index, const SphereCollider &sphere) {
+    AXL_ASSERT_MESSAGE(index < GEOMETRY_PACKET_SIZE, "SpherePacket index out of range");
+    for (i32 axis = 0; axis < 3; ++axis)
+      position[axis][index] = sphere.position[axis];
+    radius[index] = (f32)sphere.radius;
+    count = std::max(count, index + 1);
+  }
+
+  u32 SpherePacket::SphereInside(const SphereCollider &sphere) const {
+    f32 other_radius = (f32)sphere.radius;
+    u32 mask = 0;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    for (; i + 8 <= GEOMETRY_PACKET_SIZE; i += 8) {
+      __m256 dist_sqr = _mm256_setzero_ps();
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m256 d = _mm256_sub_ps(_mm256_load_ps(position[axis] + i), _mm256_set1_ps(sphere.position[axis]));
+        dist_sqr = _mm256_add_ps(dist_sqr, _mm256_mul_ps(d, d));
+      }
+      __m256 rad_sum = _mm256_add_ps(_mm256_load_ps(radius + i), _mm256_set1_ps(other_radius));
+      __m256 overlap = _mm256_cmp_ps(dist_sqr, _mm256_mul_ps(rad_sum, rad_sum), _CMP_LT_OQ);
+      mask |= (u32)_mm256_movemask_ps(overlap) << i;
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    for (; i + 4 <= GEOMETRY_PACKET_SIZE; i += 4) {
+      __m128 dist_sqr = _mm_setzero_ps();
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m128 d = _mm_sub_ps(_mm_load_ps(position[axis] + i), _mm_set1_ps(sphere.position[axis]));
+        dist_sqr = _mm_add_ps(dist_sqr, _mm_mul_ps(d, d));
+      }
+      __m128 rad_sum = _mm_add_ps(_mm_load_ps(radius + i), _mm_set1_ps(other_radius));
+      __m128 overlap = _mm_cmplt_ps(dist_sqr, _mm_mul_ps(rad_sum, rad_sum));
+      mask |= (u32)_mm_movemask_ps(overlap) << i;
+    }
+#endif
+
+    for (; i < GEOMETRY_PACKET_SIZE; ++i) {
+      f32 dist_sqr = 0.0f;
+      for (i32 axis = 0; axis < 3; ++axis) {
+        f32 d = position[axis][i] - sphere.position[axis];
+        dist_sqr += d * d;
+      }
+      f32 rad_sum = radius[i] + other_radius;
+      mask |= (u32)(dist_sqr < rad_sum * rad_sum) << i;
+    }
+
+    return mask & LaneMask(count);
+  }
+
+  u32 SpherePacket::RayInside(const Ray &ray, f32 *out_distances) const {
+    const v3 &direction = ray.GetDirection();
+    u32 mask = 0;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    for (; i + 8 <= GEOMETRY_PACKET_SIZE; i += 8) {
+      __m256 e_sqr = _mm256_setzero_ps();
+      __m256 a = _mm256_setzero_ps();
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m256 e = _mm256_sub_ps(_mm256_load_ps(position[axis] + i), _mm256_set1_ps(ray.position[axis]));
+        e_sqr = _mm256_add_ps(e_sqr, _mm256_mul_ps(e, e));
+        a = _mm256_add_ps(a, _mm256_mul_ps(e, _mm256_set1_ps(direction[axis])));
+      }
+
+      __m256 r = _mm256_load_ps(radius + i);
+      __m256 r_sqr = _mm256_mul_ps(r, r);
+      __m256 discriminant = _mm256_sub_ps(r_sqr, _mm256_sub_ps(e_sqr, _mm256_mul_ps(a, a)));
+      __m256 f = _mm256_sqrt_ps(_mm256_max_ps(discriminant, _mm256_setzero_ps()));
+
+      // Origins inside a sphere report where the ray leaves it
+      __m256 inside = _mm256_cmp_ps(e_sqr, r_sqr, _CMP_LT_OQ);
+      __m256 distance = _mm256_blendv_ps(_mm256_sub_ps(a, f), _mm256_add_ps(a, f), inside);
+      __m256 hit = _mm256_and_ps(_mm256_cmp_ps(discriminant, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                 _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+      _mm256_storeu_ps(out_distances + i, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), distance, hit));
+      mask |= (u32)_mm256_movemask_ps(hit) << i;
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    for (; i + 4 <= GEOMETRY_PACKET_SIZE; i += 4) {
+      __m128 e_sqr = _mm_setzero_ps();
+      __m128 a = _mm_setzero_ps();
+      for (i32 axis = 0; axis < 3; ++axis) {
+        __m128 e = _mm_sub_ps(_mm_load_ps(position[axis] + i), _mm_set1_ps(ray.position[axis]));
+        e_sqr = _mm_add_ps(e_sqr, _mm_mul_ps(e, e));
+        a = _mm_add_ps(a, _mm_mul_ps(e, _mm_set1_ps(direction[axis])));
+      }
+
+      __m128 r = _mm_load_ps(radius + i);
+      __m128 r_sqr = _mm_mul_ps(r, r);
+      __m128 discriminant = _mm_sub_ps(r_sqr, _mm_sub_ps(e_sqr, _mm_mul_ps(a, a)));
+      __m128 f = _mm_sqrt_ps(_mm_max_ps(discriminant, _mm_setzero_ps()));
+
+      __m128 inside = _mm_cmplt_ps(e_sqr, r_sqr);
+      __m128 distance = _mm_or_ps(_mm_and_ps(inside, _mm_add_ps(a, f)), _mm_andnot_ps(inside, _mm_sub_ps(a, f)));
+      __m128 hit = _mm_and_ps(_mm_cmpge_ps(discriminant, _mm_setzero_ps()), _mm_cmpge_ps(distance, _mm_setzero_ps()));
+      distance = _mm_or_ps(_mm_and_ps(hit, distance), _mm_andnot_ps(hit, _mm_set1_ps(-1.0f)));
+      _mm_storeu_ps(out_distances + i, distance);
+      mask |= (u32)_mm_movemask_ps(hit) << i;
+    }
+#endif
+
+    for (; i < GEOMETRY_PACKET_SIZE; ++i) {
+      f32 e_sqr = 0.0f;
+      f32 a = 0.0f;
+      for (i32 axis = 0; axis < 3; ++axis) {
+        f32 e = position[axis][i] - ray.position[axis];
+        e_sqr += e * e;
+        a += e * direction[axis];
+      }
+
+      f32 r_sqr = radius[i] * radius[i];
+      f32 discriminant = r_sqr - (e_sqr - a * a);
+      f32 f = sqrt(std::max(discriminant, 0.0f));
+      f32 distance = e_sqr < r_sqr ? a + f : a - f;
+
+      bool hit = discriminant >= 0.0f && distance >= 0.0f;
+      out_distances[i] = hit ? distance : -1.0f;
+      mask |= (u32)hit << i;
+    }
+
+    return mask & LaneMask(count);
+  }
+
+} // namespace axl
@@ -1,227 +1,436 @@
+#include <algorithm>
 #include <axolotl/ento.hh>
 #include <axolotl/geometry.hh>
+#include <axolotl/jobs.hh>
 #include <axolotl/physics.hh>
 #include <axolotl/scene.hh>
 #include <axolotl/transform.hh>
 #include <axolotl/window.hh>
+#include <axolotl/world.hh>
 #include <glm/gtx/matrix_decompose.hpp>
+#include <glm/gtx/matrix_operation.hpp>
+#include <iterator>
 
 namespace axl {
 
   constexpr f64 LINEAR_PROJECTION_PERCENT = 0.6;
   constexpr f64 PENETRATION_SLACK = 0.01;
+  // Upper bound, the solver stops earlier once impulses change less than IMPULSE_TOLERANCE
   constexpr i32 IMPULSE_ITERATIONS = 9;
+  constexpr f64 IMPULSE_TOLERANCE = 0.0001;
+  // Closing speeds below this do not bounce, keeps resting contacts from jittering
+  constexpr f64 RESTITUTION_THRESHOLD = 0.5;
+  // Candidate pairs handed to a worker at a time
+  constexpr u32 NARROWPHASE_CHUNK_SIZE = 32;
+  // Bodies slower than this, both linearly and angularly, count as resting
+  constexpr f32 SLEEP_LINEAR_VELOCITY = 0.05f;
+  constexpr f32 SLEEP_ANGULAR_VELOCITY = 0.05f;
+  // Seconds a whole island has to rest before it is put to sleep
+  constexpr f64 SLEEP_TIME = 0.5;
+  // Continuous spheres moving less than this fraction of their radius in a step cannot skip past anything
+  constexpr f32 CCD_MOTION_FRACTION = 0.5f;
+  // Conservative advancement stops once the gap closes below this
+  constexpr f32 CCD_TOLERANCE = 0.005f;
+  constexpr i32 CCD_MAX_ITERATIONS = 16;
+  // Clamped spheres are left this deep in the surface they hit, so the next narrowphase picks the contact up
+  constexpr f32 CCD_TARGET_DEPTH = 0.02f;
+
+  class NarrowphaseResult {
+   public:
+    u32 pair;
+    entt::entity a;
+    entt::entity b;
+    CollisionManifold manifold;
+  };
+
+  class SweepHit {
+   public:
+    entt::entity entity;
+    f32 time;
+    v3 point;
+    v3 normal;
+  };
 
   void RigidBody::Init() { }
 
-  void RigidBody::ApplyForces() {
-    Ento ento = Ento::FromComponent(*this);
-
-    m4 parent_model_matrix(1.0f);
-    if (ento.HasParent())
-      parent_model_matrix = ento.Transform().GetParentModelMatrix();
-    quat rotation = quat_cast(parent_model_matrix);
-    rotation = conjugate(rotation);
-
-    forces = rotation * v3(0.0f, -GRAVITATIONAL_CONSTANT, 0.0f) * (f32)mass;
-  }
-
   f64 RigidBody::InvMass() const {
     return mass == 0.0 ? 0.0 : 1.0 / mass;
   }
 
-  m4 RigidBody::InvTensor() const {
-    if (mass == 0.0)
-      return m4(0.0);
-
-    Ento ento = Ento::FromComponent(*this);
+  const m3 &RigidBody::InvTensor() const {
+    return _inv_tensor;
+  }
 
-    f64 ix = 0.0;
-    f64 iy = 0.0;
-    f64 iz = 0.0;
-    f64 iw = 0.0;
-
-    if (ento.HasComponent<SphereCollider>()) {
-      SphereCollider sphere = ento.GetComponent<SphereCollider>();
-      f64 r2 = sphere.radius * sphere.radius;
-      constexpr f64 fraction = (2.0 / 5.0);
-
-      ix = r2 * mass * fraction;
-      iy = r2 * mass * fraction;
-      iz = r2 * mass * fraction;
-      iw = 1.0;
-    } else if (ento.HasComponent<OBBCollider>()) {
-      OBBCollider obb = ento.GetComponent<OBBCollider>();
-      v3 size = obb.size * 2.0f;
-      constexpr f64 fraction = (1.0 / 12.0);
-      f64 x2 = size.x * size.x;
-      f64 y2 = size.y * size.y;
-      f64 z2 = size.z * size.z;
-
-      ix = (y2 + z2) * mass * fraction;
-      iy = (x2 + z2) * mass * fraction;
-      iz = (x2 + y2) * mass * fraction;
-      iw = 1.0;
+  void RigidBody::UpdateInertia(const SphereCollider *sphere, const OBBCollider *obb) {
+    // The shape key is the radius for spheres and the half-size for boxes
+    v3 shape(0.0f);
+    if (sphere)
+      shape = v3((f32)sphere->radius);
+    else if (obb)
+      shape = obb->size;
+
+    if (mass != _inertia_mass || shape != _inertia_shape) {
+      _inertia_mass = mass;
+      _inertia_shape = shape;
+      _inv_inertia_local = v3(0.0f);
+
+      if (mass != 0.0 && sphere) {
+        f64 inertia = sphere->radius * sphere->radius * mass * (2.0 / 5.0);
+        _inv_inertia_local = v3((f32)(1.0 / inertia));
+      } else if (mass != 0.0 && obb) {
+        v3 size = obb->size * 2.0f;
+        constexpr f64 fraction = (1.0 / 12.0);
+        f64 x2 = size.x * size.x;
+        f64 y2 = size.y * size.y;
+        f64 z2 = size.z * size.z;
+
+        _inv_inertia_local = v3((f32)(1.0 / ((y2 + z2) * mass * fraction)),
+                                (f32)(1.0 / ((x2 + z2) * mass * fraction)),
+                                (f32)(1.0 / ((x2 + y2) * mass * fraction)));
+      }
     }
 
-    return inverse(m4((f32)ix, 0, 0, 0, 0, (f32)iy, 0, 0, 0, 0, (f32)iz, 0, 0, 0, 0, (f32)iw));
+    // Spheres are the same from every side, boxes follow their axes
+    m3 inv_inertia = diagonal3x3(_inv_inertia_local);
+    if (!sphere && obb) {
+      const m3 &axes = obb->GetRotationMatrix();
+      _inv_tensor = axes * inv_inertia * transpose(axes);
+    } else {
+      _inv_tensor = inv_inertia;
+    }
   }
 
   void RigidBody::AddRotationalImpulse(const v3 &point, const v3 &impulse) {
     Ento ento = Ento::FromComponent(*this);
 
+    Wake();
     v3 center_of_mass = ento.Transform().GetPosition();
     v3 torque = cross(point - center_of_mass, impulse);
-    v3 angular_acceleration = v4(torque, 1.0) * InvTensor();
+    v3 angular_acceleration = torque * InvTensor();
     angular_velocity = angular_velocity + angular_acceleration;
   }
 
   void RigidBody::AddLinearImpulse(const v3 &impulse) {
+    Wake();
     velocity = velocity + impulse;
   }
 
-  CollisionManifold RigidBody::FindCollisionFeatures(const RigidBody &other) const {
-    CollisionManifold result;
+  bool RigidBody::IsAwake() const {
+    return _awake;
+  }
 
+  void RigidBody::Wake() {
+    _awake = true;
+    _sleep_time = 0.0;
+  }
+
+  void RigidBody::Sleep() {
+    _awake = false;
+    velocity = v3(0.0f);
+    angular_velocity = v3(0.0f);
+  }
+
+  // Pairs of sleeping bodies, or of a sleeping body and a static one that did not move, skip the narrowphase.
+  // Static pairs are always tested, their overlaps are still reported to the game.
+  static bool IsPairAsleep(const entt::registry &registry, entt::entity a, entt::entity b) {
+    const RigidBody &body_a = registry.get<RigidBody>(a);
+    const RigidBody &body_b = registry.get<RigidBody>(b);
+    if (body_a.IsAwake() || body_b.IsAwake())
+      return false;
+    return body_a.InvMass() != 0.0 || body_b.InvMass() != 0.0;
+  }
+
+  CollisionManifold RigidBody::FindCollisionFeatures(const RigidBody &other) const {
     Ento ento = Ento::FromComponent(*this);
     Ento other_ento = Ento::FromComponent(other);
 
-    if (ento.HasComponent<SphereCollider>()) {
-      SphereCollider &sphere = ento.GetComponent<SphereCollider>();
+    return Physics::Collide(Scene::GetActiveScene()->GetRegistry(), ento, other_ento);
+  }
+
+  CollisionManifold Physics::Collide(const entt::registry &registry, entt::entity a, entt::entity b) {
+    CollisionManifold result;
 
-      if (other_ento.HasComponent<SphereCollider>()) {
-        SphereCollider &other_sphere = other_ento.GetComponent<SphereCollider>();
-        result = sphere.SphereCollide(other_sphere);
-      } else if (other_ento.HasComponent<OBBCollider>()) {
-        OBBCollider &other_obb = other_ento.GetComponent<OBBCollider>();
-        result = sphere.OBBCollide(other_obb);
+    // Only reads from the registry, safe to call from the job system
+    if (const SphereCollider *sphere = registry.try_get<SphereCollider>(a)) {
+      if (const SphereCollider *other_sphere = registry.try_get<SphereCollider>(b)) {
+        result = sphere->SphereCollide(*other_sphere);
+      } else if (const OBBCollider *other_obb = registry.try_get<OBBCollider>(b)) {
+        result = sphere->OBBCollide(*other_obb);
         result.normal = -result.normal;
       }
-      // INFO: This works, just that performance is terrible, and it is not used in the game.
-      //
-      // } else if (ento.HasComponent<OBBCollider>()) {
-      //   OBBCollider &obb = ento.GetComponent<OBBCollider>();
-
-      //   if (other_ento.HasComponent<SphereCollider>()) {
-      //     SphereCollider &other_sphere = other_ento.GetComponent<SphereCollider>();
-      //     result = obb.SphereCollide(other_sphere);
-      //   } else if (other_ento.HasComponent<OBBCollider>()) {
-      //     OBBCollider &other_obb = other_ento.GetComponent<OBBCollider>();
-      //     result = obb.OBBCollide(other_obb);
-      //     result.normal = -result.normal;
-      //   }
+    } else if (const OBBCollider *obb = registry.try_get<OBBCollider>(a)) {
+      if (const SphereCollider *other_sphere = registry.try_get<SphereCollider>(b)) {
+        result = obb->SphereCollide(*other_sphere);
+      } else if (const OBBCollider *other_obb = registry.try_get<OBBCollider>(b)) {
+        result = obb->OBBCollide(*other_obb);
+      }
     }
 
     return result;
   }
 
-  void RigidBody::ApplyImpulse(RigidBody &other, const CollisionManifold &manifold, i32 c) {
-    f64 inv_mass_a = InvMass();
-    f64 inv_mass_b = other.InvMass();
-    f64 inv_mass = inv_mass_a + inv_mass_b;
-
-    if (inv_mass == 0.0)
-      return;
+  RaycastHit Physics::Raycast(Scene &scene, const Ray &ray, RaycastMode mode, u32 mask, entt::entity ignore,
+                              f32 max_distance) {
+    RaycastHit hit;
+    RaycastBatch(scene, &ray, 1, &hit, mode, mask, ignore, max_distance);
+    return hit;
+  }
 
-    Ento ento = Ento::FromComponent(*this);
-    Ento other_ento = Ento::FromComponent(other);
+  void Physics::RaycastBatch(Scene &scene, const Ray *rays, u32 count, RaycastHit *out_hits, RaycastMode mode,
+                             u32 mask, entt::entity ignore, f32 max_distance) {
+    const entt::registry &registry = scene.GetRegistry();
+    const Broadphase &broadphase = scene.GetBroadphase();
+
+    for (u32 first = 0; first < count; first += BROADPHASE_RAY_PACKET_SIZE) {
+      RayPacket packet;
+      packet.count = min(count - first, BROADPHASE_RAY_PACKET_SIZE);
+      for (u32 i = 0; i < packet.count; ++i) {
+        packet.Set(i, rays[first + i].position, rays[first + i].GetDirection(), max_distance);
+        out_hits[first + i] = RaycastHit();
+      }
 
-    v3 relative_point = manifold.points[c];
-    v3 r_a = relative_point - ento.Transform().GetPosition();
-    v3 r_b = relative_point - other_ento.Transform().GetPosition();
-    m4 i_a = InvTensor();
-    m4 i_b = other.InvTensor();
+      broadphase.QueryRays(packet, [&](u32 index, i32 leaf) {
+        const BroadphaseNode &node = broadphase.GetNode(leaf);
+        if (node.entity == ignore || !(node.layers & mask))
+          return;
+
+        // The tree only holds fat bounds, the collider decides. Spheres take precedence like in the narrowphase.
+        const Ray &ray = rays[first + index];
+        f64 distance = -1.0;
+        if (const SphereCollider *sphere = registry.try_get<SphereCollider>(node.entity))
+          distance = ray.SphereInside(*sphere);
+        else if (const OBBCollider *obb = registry.try_get<OBBCollider>(node.entity))
+          distance = ray.OBBInside(*obb);
+
+        if (distance < 0.0 || distance > packet.max_distance[index])
+          return;
+
+        RaycastHit &hit = out_hits[first + index];
+        hit.entity = node.entity;
+        hit.distance = (f32)distance;
+        hit.point = ray.position + ray.GetDirection() * (f32)distance;
+
+        // Only closer hits matter from now on, an any hit ray is done
+        packet.max_distance[index] = mode == RaycastMode::Any ? -1.0f : (f32)distance;
+      });
+    }
+  }
 
-    v3 relative_velocity =
-      (other.velocity + cross(other.angular_velocity, r_b)) - (velocity + cross(angular_velocity, r_a));
-    v3 relative_normal = normalize(manifold.normal);
+  void RigidBody::ApplyImpulse(RigidBody &other, const ContactConstraint &contact, const ContactPoint &point,
+                               const v3 &impulse) {
+    velocity = velocity - impulse * (f32)contact.inv_mass_a;
+    other.velocity = other.velocity + impulse * (f32)contact.inv_mass_b;
 
-    if (dot(relative_velocity, relative_normal) > 0.0)
-      return;
+    angular_velocity = angular_velocity - cross(point.r_a, impulse) * contact.inv_tensor_a;
+    other.angular_velocity = other.angular_velocity + cross(point.r_b, impulse) * contact.inv_tensor_b;
+  }
 
-    f64 e = min(cor, other.cor);
-    f64 numerator = (-(1.0 + e) * dot(relative_velocity, relative_normal));
-    f64 d1 = inv_mass;
-    v3 d2 = cross(v3(v4(cross(r_a, relative_normal), 1.0) * i_a), r_a);
-    v3 d3 = cross(v3(v4(cross(r_b, relative_normal), 1.0) * i_b), r_b);
-    f64 denominator = d1 + dot(relative_normal, d2 + d3);
-    f64 j = (denominator == 0.0) ? 0.0 : numerator / denominator;
+  static f64 EffectiveMass(const ContactConstraint &contact, const ContactPoint &point, const v3 &direction) {
+    v3 d_a = cross(cross(point.r_a, direction) * contact.inv_tensor_a, point.r_a);
+    v3 d_b = cross(cross(point.r_b, direction) * contact.inv_tensor_b, point.r_b);
+    f64 k = contact.inv_mass_a + contact.inv_mass_b + dot(direction, d_a + d_b);
+    return k > 0.0 ? 1.0 / k : 0.0;
+  }
 
-    if (manifold.points.size() > 0.0 && j != 0.0)
-      j /= manifold.points.size();
+  static v3 RelativeVelocity(const RigidBody &a, const RigidBody &b, const ContactPoint &point) {
+    return (b.velocity + cross(b.angular_velocity, point.r_b)) - (a.velocity + cross(a.angular_velocity, point.r_a));
+  }
 
-    v3 impulse = (f32)j * relative_normal;
-    velocity = velocity - impulse * (f32)inv_mass_a;
-    other.velocity = other.velocity + impulse * (f32)inv_mass_b;
+  void ContactConstraint::Prepare(const CollisionManifold &manifold,
+                                  const RigidBody &body_a,
+                                  const RigidBody &body_b,
+                                  const v3 &position_a,
+                                  const v3 &position_b) {
+    normal = normalize(manifold.normal);
+    depth = manifold.depth;
+    friction = sqrt(body_a.friction * body_b.friction);
+    inv_mass_a = body_a.InvMass();
+    inv_mass_b = body_b.InvMass();
+    inv_tensor_a = body_a.InvTensor();
+    inv_tensor_b = body_b.InvTensor();
+
+    const v3 &n = normal;
+    if (abs(n.x) >= 0.57735f)
+      tangents[0] = normalize(v3(n.y, -n.x, 0.0f));
+    else
+      tangents[0] = normalize(v3(0.0f, n.z, -n.y));
+    tangents[1] = cross(n, tangents[0]);
+
+    FixedVector<ContactPoint, MANIFOLD_MAX_POINTS> old_points = points;
+    // Start from zeroed points, resize alone would leave the impulses of whatever sat at each index last step
+    points.clear();
+    points.resize(manifold.points.size());
+
+    f64 e = min(body_a.cor, body_b.cor);
+
+    for (u32 i = 0; i < manifold.points.size(); ++i) {
+      ContactPoint &point = points[i];
+      point.position = manifold.points[i];
+      point.r_a = point.position - position_a;
+      point.r_b = point.position - position_b;
+      point.normal_mass = EffectiveMass(*this, point, n);
+      point.tangent_mass[0] = EffectiveMass(*this, point, tangents[0]);
+      point.tangent_mass[1] = EffectiveMass(*this, point, tangents[1]);
+
+      f64 normal_velocity = dot(RelativeVelocity(body_a, body_b, point), n);
+      point.velocity_bias = normal_velocity < -RESTITUTION_THRESHOLD ? -e * normal_velocity : 0.0;
+
+      for (const ContactPoint &old_point : old_points) {
+        if (distance2(old_point.position, point.position) > CONTACT_MATCH_DISTANCE * CONTACT_MATCH_DISTANCE)
+          continue;
+        point.normal_impulse = old_point.normal_impulse;
+        point.tangent_impulse[0] = old_point.tangent_impulse[0];
+        point.tangent_impulse[1] = old_point.tangent_impulse[1];
+        break;
+      }
+    }
+  }
 
-    angular_velocity = angular_velocity - v3(v4(cross(r_a, impulse), 1.0) * i_a);
-    other.angular_velocity = other.angular_velocity + v3(v4(cross(r_b, impulse), 1.0) * i_b);
+  static void WarmStartContact(const ContactConstraint &contact, RigidBody &a, RigidBody &b) {
+    for (const ContactPoint &point : contact.points) {
+      v3 impulse = contact.normal * (f32)point.normal_impulse + contact.tangents[0] * (f32)point.tangent_impulse[0] +
+                   contact.tangents[1] * (f32)point.tangent_impulse[1];
+      a.ApplyImpulse(b, contact, point, impulse);
+    }
+  }
 
-    // friction
+  // Returns the largest normal impulse change, used to stop iterating once the solver settles
+  static f64 SolveContact(ContactConstraint &contact, RigidBody &a, RigidBody &b) {
+    f64 max_delta = 0.0;
+
+    for (ContactPoint &point : contact.points) {
+      // Friction first, so the normal constraint has the last word
+      for (i32 k = 0; k < 2; ++k) {
+        const v3 &t = contact.tangents[k];
+        f64 delta = -dot(RelativeVelocity(a, b, point), t) * point.tangent_mass[k];
+        f64 max_friction = contact.friction * point.normal_impulse;
+        f64 accumulated = clamp(point.tangent_impulse[k] + delta, -max_friction, max_friction);
+        delta = accumulated - point.tangent_impulse[k];
+        point.tangent_impulse[k] = accumulated;
+
+        a.ApplyImpulse(b, contact, point, t * (f32)delta);
+      }
 
-    v3 t = relative_velocity - (relative_normal * dot(relative_velocity, relative_normal));
-    if (epsilonEqual(length2(t), 0.0f, std::numeric_limits<f32>::epsilon()))
-      return;
-    t = normalize(t);
+      f64 normal_velocity = dot(RelativeVelocity(a, b, point), contact.normal);
+      f64 delta = point.normal_mass * (-normal_velocity + point.velocity_bias);
+      f64 accumulated = max(point.normal_impulse + delta, 0.0);
+      delta = accumulated - point.normal_impulse;
+      point.normal_impulse = accumulated;
 
-    numerator = -dot(relative_velocity, t);
-    d1 = inv_mass;
-    d2 = cross(v3(v4(cross(r_a, t), 1.0) * i_a), r_a);
-    d3 = cross(v3(v4(cross(r_b, t), 1.0) * i_b), r_b);
-    denominator = d1 + dot(t, d2 + d3);
+      a.ApplyImpulse(b, contact, point, contact.normal * (f32)delta);
+      max_delta = max(max_delta, abs(delta));
+    }
 
-    f64 jt = denominator == 0.0 ? 0.0f : numerator / denominator;
+    return max_delta;
+  }
 
-    if (manifold.points.size() > 0.0 && jt != 0.0)
-      jt /= manifold.points.size();
+  // Gap between a sphere at center and the collider of entity, point is the closest point on that collider
+  static f32
+  SweepDistance(const entt::registry &registry, entt::entity entity, const v3 &center, f32 radius, v3 &point) {
+    if (const SphereCollider *sphere = registry.try_get<SphereCollider>(entity)) {
+      v3 offset = center - sphere->position;
+      f32 distance = length(offset);
+      point = sphere->position;
+      if (distance > 0.0f)
+        point += offset * ((f32)sphere->radius / distance);
+      return distance - (f32)sphere->radius - radius;
+    }
 
-    if (epsilonEqual(jt, 0.0, std::numeric_limits<f64>::epsilon()))
-      return;
+    point = registry.get<OBBCollider>(entity).ClosestPoint(center);
+    return length(center - point) - radius;
+  }
 
-    f64 frict = sqrt(friction * other.friction);
-    f64 jt_clamped = clamp(jt, -frict, frict);
+  // Conservative advancement against a collider that holds still during the step. The gap can never close faster
+  // than the sphere moves, so advancing by gap / speed never steps past the first touch.
+  static bool SweepSphere(const entt::registry &registry,
+                          entt::entity other,
+                          const SphereCollider &sphere,
+                          const v3 &motion,
+                          SweepHit &hit) {
+    f32 motion_length = length(motion);
+    f32 radius = (f32)sphere.radius;
+    f32 time = 0.0f;
+
+    for (i32 i = 0; i < CCD_MAX_ITERATIONS; ++i) {
+      v3 center = sphere.position + motion * time;
+      v3 point;
+      f32 distance = SweepDistance(registry, other, center, radius, point);
+
+      // Already overlapping, the discrete contact handles it
+      if (i == 0 && distance <= 0.0f)
+        return false;
+
+      if (distance < CCD_TOLERANCE || i == CCD_MAX_ITERATIONS - 1) {
+        v3 normal = center - point;
+        if (length2(normal) == 0.0f)
+          return false;
+        normal = normalize(normal);
+
+        // Grazing or separating, nothing to tunnel through
+        if (dot(motion, normal) >= 0.0f)
+          return false;
+
+        hit = { other, time, point, normal };
+        return true;
+      }
 
-    v3 tangent_impulse = (f32)jt_clamped * t;
+      time += distance / motion_length;
+      if (time >= 1.0f)
+        return false;
+    }
 
-    velocity = velocity - tangent_impulse * (f32)inv_mass_a;
-    other.velocity = other.velocity + tangent_impulse * (f32)inv_mass_b;
-    angular_velocity = angular_velocity - v3(v4(cross(r_a, tangent_impulse), 1.0) * i_a);
-    other.angular_velocity = other.angular_velocity + v3(v4(cross(r_b, tangent_impulse), 1.0) * i_b);
+    return false;
   }
 
-  void RigidBody::Update(f64 step) {
-    colliding_with.clear();
-    Ento ento = Ento::FromComponent(*this);
-    v3 acceleration = forces * (f32)InvMass();
-    velocity = velocity + acceleration * (f32)step;
-    velocity = velocity * (f32)damping;
-
-    if (abs(velocity.x) < 0.001)
-      velocity.x = 0.0f;
-    if (abs(velocity.y) < 0.001)
-      velocity.y = 0.0f;
-    if (abs(velocity.z) < 0.001)
-      velocity.z = 0.0f;
-
-    if (ento.HasComponent<OBBCollider>()) {
-      v3 angular_acceleration = v4(torques, 1.0f) * InvTensor();
-      angular_velocity = angular_velocity + angular_acceleration * (f32)step;
-      angular_velocity = angular_velocity * (f32)damping;
-
-      if (angular_velocity.x < 0.001)
-        angular_velocity.x = 0.0f;
-      if (angular_velocity.y < 0.001)
-        angular_velocity.y = 0.0f;
-      if (angular_velocity.z < 0.001)
-        angular_velocity.z = 0.0f;
-    }
-
-    // ento.Transform().SetPosition(ento.Transform().GetPosition() + velocity * (f32)step);
-    // ento.Transform().SetRotationEuler(ento.Transform().GetRotationEuler() + angular_velocity * (f32)step);
+  // Fast continuous spheres are swept against every collider their motion this step crosses. Only the first hit is
+  // kept, it is resolved after integration by pushing the sphere back to the surface along the hit normal.
+  static void SweepContinuous(entt::registry &registry,
+                              const Broadphase &broadphase,
+                              f64 step,
+                              std::vector<SweepHit> &sweeps,
+                              std::vector<entt::entity> &swept) {
+    sweeps.clear();
+    swept.clear();
+
+    registry.view<RigidBody, SphereCollider>().each(
+      [&](entt::entity entity, const RigidBody &body, const SphereCollider &sphere) {
+        if (!body.continuous || body.is_trigger || !body.IsAwake() || body.InvMass() == 0.0)
+          return;
+        // Velocities are in parent space, only root bodies move in world space
+        const HierarchyComponent *hierarchy = registry.try_get<HierarchyComponent>(entity);
+        if (hierarchy && !hierarchy->parent.is_nil())
+          return;
+
+        v3 motion = body.velocity * (f32)step;
+        if (length(motion) < (f32)sphere.radius * CCD_MOTION_FRACTION)
+          return;
+
+        v3 end = sphere.position + motion;
+        v3 min = glm::min(sphere.position, end) - v3((f32)sphere.radius);
+        v3 max = glm::max(sphere.position, end) + v3((f32)sphere.radius);
+
+        SweepHit first { entt::null, 1.0f };
+        broadphase.Query(min, max, [&](i32 index) {
+          entt::entity other = broadphase.GetNode(index).entity;
+          if (other == entity || registry.get<RigidBody>(other).is_trigger)
+            return true;
+
+          SweepHit hit;
+          if (SweepSphere(registry, other, sphere, motion, hit) && hit.time < first.time)
+            first = hit;
+          return true;
+        });
+
+        if (first.entity != entt::null) {
+          sweeps.push_back(first);
+          swept.push_back(entity);
+        }
+      });
   }
 
   void Physics::Step(Scene &scene, f64 step) {
     entt::registry &registry = scene.GetRegistry();
+    scene.UpdateTransforms();
 
     registry.view<Transform, OBBCollider>().each([&](entt::entity entity, Transform &transform, OBBCollider &collider) {
       if (transform.WasDirty()) {
@@ -239,6 +448,10 @@ namespace axl {
         collider.position = translation;
         collider.size = scale;
         collider.SetRotation(rotation);
+
+        RigidBody *body = registry.try_get<RigidBody>(entity);
+        if (body && !body->IsAwake())
+          body->Wake();
       }
     });
     registry.view<Transform, SphereCollider>().each(
@@ -256,96 +469,249 @@ namespace axl {
 
           collider.position = translation;
           collider.radius = scale.x;
+
+          RigidBody *body = registry.try_get<RigidBody>(entity);
+          if (body && !body->IsAwake())
+            body->Wake();
         }
       });
     i32 rb_times = 0;
 
-    std::vector<CollisionManifold> manifolds;
-    manifolds.reserve(registry.size());
-    std::vector<RigidBody *> colliders_a;
-    colliders_a.reserve(registry.size());
-    std::vector<RigidBody *> colliders_b;
-    colliders_b.reserve(registry.size());
-
-    registry.group<Transform, RigidBody>().each([&](entt::entity entity, Transform &transform, RigidBody &body) {
-      body.ApplyForces();
-      body.Update(step);
-      Ento ento = scene.FromHandle(entity);
+    PhysicsWorld &world = scene.GetPhysicsWorld();
+    world.Gather(registry);
+    world.IntegrateVelocities(registry, step);
 
-      if (ento.HasAnyOf<SphereCollider, OBBCollider>()) {
-        registry.view<Transform, RigidBody>().each(
-          [&](entt::entity other_entity, Transform &other_transform, RigidBody &other_body) {
-            Ento other_ento = scene.FromHandle(other_entity);
+    Broadphase &broadphase = scene.GetBroadphase();
+    broadphase.Begin();
+    registry.view<RigidBody, SphereCollider>().each(
+      [&](entt::entity entity, RigidBody &body, SphereCollider &collider) {
+        AABBCollider bounds = collider.GetBounds();
+        broadphase.Update(entity, bounds.GetMin(), bounds.GetMax(), body.layers);
+      });
+    registry.view<RigidBody, OBBCollider>().each([&](entt::entity entity, RigidBody &body, OBBCollider &collider) {
+      // Spheres take precedence in the narrowphase, keep the proxy consistent with it
+      if (registry.all_of<SphereCollider>(entity))
+        return;
+      AABBCollider bounds = collider.GetBounds();
+      broadphase.Update(entity, bounds.GetMin(), bounds.GetMax(), body.layers);
+    });
+    broadphase.End();
+
+    FrameVector<BroadphasePair> pairs;
+    broadphase.QueryPairs(pairs);
+
+    broadphase_pair_count = pairs.size();
+    broadphase_proxy_count = broadphase.GetProxyCount();
+
+    ContactCache &contacts = scene.GetContactCache();
+    contacts.Begin();
+
+    // Nothing in a sleeping pair moved, it keeps the contacts from the step it fell asleep in
+    pairs.erase(std::remove_if(pairs.begin(),
+                               pairs.end(),
+                               [&](const BroadphasePair &pair) {
+                                 if (!IsPairAsleep(registry, pair.a, pair.b))
+                                   return false;
+
+                                 if (contacts.Keep(pair.a, pair.b)) {
+                                   registry.get<RigidBody>(pair.a).colliding_with.push_back(scene.FromHandle(pair.b));
+                                   registry.get<RigidBody>(pair.b).colliding_with.push_back(scene.FromHandle(pair.a));
+                                 }
+                                 return true;
+                               }),
+                pairs.end());
+
+    // Narrowphase is pure math over the colliders, run it on the job system into per-thread buffers
+    static std::vector<std::vector<NarrowphaseResult>> thread_results;
+    thread_results.resize(JobSystem::GetThreadCount());
+    for (std::vector<NarrowphaseResult> &results : thread_results)
+      results.clear();
+
+    f64 start = Window::GetCurrentWindow()->GetTime();
+    JobSystem::ParallelFor(pairs.size(), NARROWPHASE_CHUNK_SIZE, [&](u32 begin, u32 end, u32 thread_index) {
+      std::vector<NarrowphaseResult> &results = thread_results[thread_index];
+
+      for (u32 i = begin; i < end; ++i) {
+        const BroadphasePair &pair = pairs[i];
+        // Broadphase pairs come ordered a < b, one test per pair gives a single manifold with its normal from a to b
+        CollisionManifold manifold = Collide(registry, pair.a, pair.b);
+        if (manifold.colliding)
+          results.push_back({ i, pair.a, pair.b, std::move(manifold) });
+      }
+    });
+    f64 end = Window::GetCurrentWindow()->GetTime();
+    total_physics_time += end - start;
+
+    // Chunks are handed out dynamically, restore the pair order so the solver input does not depend on scheduling
+    static std::vector<NarrowphaseResult> merged;
+    merged.clear();
+    for (std::vector<NarrowphaseResult> &results : thread_results)
+      std::move(results.begin(), results.end(), std::back_inserter(merged));
+    std::stable_sort(merged.begin(), merged.end(), [](const NarrowphaseResult &a, const NarrowphaseResult &b) {
+      return a.pair < b.pair;
+    });
 
-            if (other_ento.id == ento.id)
-              return;
+    for (NarrowphaseResult &result : merged) {
+      RigidBody &body = registry.get<RigidBody>(result.a);
+      RigidBody &other_body = registry.get<RigidBody>(result.b);
 
-            f64 start = Window::GetCurrentWindow()->GetTime();
-            CollisionManifold manifold = body.FindCollisionFeatures(other_body);
-            f64 end = Window::GetCurrentWindow()->GetTime();
-            total_physics_time += end - start;
+      body.colliding_with.push_back(scene.FromHandle(result.b));
+      other_body.colliding_with.push_back(scene.FromHandle(result.a));
 
-            if (!manifold.colliding)
-              return;
+      // Overlaps are only reported for tested pairs, bodies inside a trigger are kept awake
+      if (body.is_trigger || other_body.is_trigger) {
+        body.Wake();
+        other_body.Wake();
+        continue;
+      }
 
-            body.colliding_with.push_back(other_ento);
+      // One side is awake, it is about to push the other one
+      if (!body.IsAwake())
+        body.Wake();
+      if (!other_body.IsAwake())
+        other_body.Wake();
 
-            if (body.is_trigger || other_body.is_trigger)
-              return;
+      if (body.InvMass() + other_body.InvMass() == 0.0)
+        continue;
 
-            manifolds.emplace_back(manifold);
-            colliders_a.push_back(&body);
-            colliders_b.push_back(&other_body);
-          });
-      }
-    });
+      ContactConstraint &contact = contacts.Get(result.a, result.b);
+      contact.Prepare(result.manifold,
+                      body,
+                      other_body,
+                      registry.get<Transform>(result.a).GetPosition(),
+                      registry.get<Transform>(result.b).GetPosition());
+    }
     // log::info("Physics Step: {}", rb_times);
     // total_physics_time /= (f32)rb_times;
 
-    for (i32 i = 0; i < IMPULSE_ITERATIONS; ++i) {
-      for (CollisionManifold &manifold : manifolds) {
-        i32 p_size = manifold.points.size();
-        for (i32 j = 0; j < p_size; ++j) {
-          RigidBody *a = colliders_a[j];
-          RigidBody *b = colliders_b[j];
+    contacts.End();
+    std::vector<ContactConstraint *> &active = contacts.GetActive();
+    contact_count = active.size();
 
-          a->ApplyImpulse(*b, manifold, j);
-        }
+    for (ContactConstraint *contact : active)
+      WarmStartContact(*contact, registry.get<RigidBody>(contact->a), registry.get<RigidBody>(contact->b));
+
+    solver_iteration_count = 0;
+    for (i32 i = 0; i < IMPULSE_ITERATIONS && !active.empty(); ++i) {
+      f64 max_delta = 0.0;
+      for (ContactConstraint *contact : active) {
+        RigidBody &a = registry.get<RigidBody>(contact->a);
+        RigidBody &b = registry.get<RigidBody>(contact->b);
+        max_delta = max(max_delta, SolveContact(*contact, a, b));
       }
+
+      solver_iteration_count++;
+      if (max_delta < IMPULSE_TOLERANCE)
+        break;
     }
 
-    registry.group<Transform, RigidBody>().each([&](entt::entity entity, Transform &transform, RigidBody &body) {
-      Ento ento = scene.FromHandle(entity);
-      if (epsilonNotEqual(length2(body.velocity), 0.0f, std::numeric_limits<f32>::epsilon())) {
-        transform.SetPosition(transform.GetPosition() + body.velocity * (f32)step);
+    static std::vector<SweepHit> sweeps;
+    static std::vector<entt::entity> swept;
+    SweepContinuous(registry, broadphase, step, sweeps, swept);
+    continuous_hit_count = sweeps.size();
+
+    world.IntegratePositions(registry, step);
+
+    for (u32 i = 0; i < sweeps.size(); ++i) {
+      const SweepHit &hit = sweeps[i];
+      Transform &transform = registry.get<Transform>(swept[i]);
+      f32 radius = (f32)registry.get<SphereCollider>(swept[i]).radius;
+
+      // Only the motion past the surface is undone, sliding along it is kept
+      f32 gap = dot(transform.GetPosition() - hit.point, hit.normal) - radius;
+      if (gap < -CCD_TARGET_DEPTH)
+        transform.SetPosition(transform.GetPosition() + hit.normal * (-CCD_TARGET_DEPTH - gap));
+    }
+
+    for (ContactConstraint *contact : active) {
+      f64 total_mass = contact->inv_mass_a + contact->inv_mass_b;
+
+      f64 depth = max(contact->depth - PENETRATION_SLACK, 0.0);
+      f64 scalar = depth / total_mass;
+      v3 correction = contact->normal * (f32)scalar * (f32)LINEAR_PROJECTION_PERCENT;
+
+      // Static bodies are left alone, a dirty transform would wake everything resting on them
+      if (contact->inv_mass_a != 0.0) {
+        Transform &transform_a = registry.get<Transform>(contact->a);
+        transform_a.SetPosition(transform_a.GetPosition() - correction * (f32)contact->inv_mass_a);
       }
-      if (ento.HasComponent<OBBCollider>() &&
-          epsilonNotEqual(length2(body.angular_velocity), 0.0f, std::numeric_limits<f32>::epsilon())) {
-        transform.SetRotationEuler(transform.GetRotationEuler() + degrees(body.angular_velocity) * (f32)step);
-        // log::debug("Ento {} has angular velocity {}, step is {}",
-        //            ento.Tag().value,
-        //            to_string(body.angular_velocity),
-        //            step);
+      if (contact->inv_mass_b != 0.0) {
+        Transform &transform_b = registry.get<Transform>(contact->b);
+        transform_b.SetPosition(transform_b.GetPosition() + correction * (f32)contact->inv_mass_b);
       }
-    });
+    }
+
+    UpdateIslands(registry, contacts, step);
+  }
 
-    for (i32 i = 0; i < manifolds.size(); ++i) {
-      CollisionManifold &manifold = manifolds[i];
-      RigidBody *a = colliders_a[i];
-      RigidBody *b = colliders_b[i];
+  entt::entity Physics::FindIsland(entt::registry &registry, entt::entity entity) {
+    while (true) {
+      RigidBody &body = registry.get<RigidBody>(entity);
+      if (body._island == entity)
+        return entity;
+
+      // Path halving, every visited body skips to its grandparent
+      body._island = registry.get<RigidBody>(body._island)._island;
+      entity = body._island;
+    }
+  }
 
-      f64 total_mass = a->InvMass() + b->InvMass();
-      if (total_mass == 0.0)
+  void Physics::UpdateIslands(entt::registry &registry, ContactCache &contacts, f64 step) {
+    auto bodies = registry.view<RigidBody>();
+
+    for (entt::entity entity : bodies) {
+      RigidBody &body = bodies.get<RigidBody>(entity);
+      body._island = entity;
+      body._island_sleep_time = std::numeric_limits<f64>::max();
+
+      if (body.InvMass() == 0.0) {
+        body._awake = false;
         continue;
+      }
 
-      f64 depth = max(manifold.depth - PENETRATION_SLACK, 0.0);
-      f64 scalar = depth / total_mass;
-      v3 correction = manifold.normal * (f32)scalar * (f32)LINEAR_PROJECTION_PERCENT;
+      if (body._awake) {
+        bool resting = length2(body.velocity) < SLEEP_LINEAR_VELOCITY * SLEEP_LINEAR_VELOCITY &&
+                       length2(body.angular_velocity) < SLEEP_ANGULAR_VELOCITY * SLEEP_ANGULAR_VELOCITY;
+        body._sleep_time = resting ? body._sleep_time + step : 0.0;
+      }
+    }
 
-      Ento ento_a = Ento::FromComponent(*a);
-      ento_a.Transform().SetPosition(ento_a.Transform().GetPosition() - correction * (f32)a->InvMass());
-      Ento ento_b = Ento::FromComponent(*b);
-      ento_b.Transform().SetPosition(ento_b.Transform().GetPosition() + correction * (f32)b->InvMass());
+    // Static bodies do not join islands, otherwise everything on the floor would sleep and wake together
+    for (std::vector<ContactConstraint *> *list : { &contacts.GetActive(), &contacts.GetSleeping() }) {
+      for (ContactConstraint *contact : *list) {
+        if (contact->inv_mass_a == 0.0 || contact->inv_mass_b == 0.0)
+          continue;
+
+        entt::entity a = FindIsland(registry, contact->a);
+        entt::entity b = FindIsland(registry, contact->b);
+        if (a != b)
+          registry.get<RigidBody>(a)._island = b;
+      }
+    }
+
+    for (entt::entity entity : bodies) {
+      RigidBody &body = bodies.get<RigidBody>(entity);
+      if (body.InvMass() == 0.0)
+        continue;
+
+      RigidBody &root = registry.get<RigidBody>(FindIsland(registry, entity));
+      root._island_sleep_time = min(root._island_sleep_time, body._sleep_time);
+    }
+
+    sleeping_body_count = 0;
+    for (entt::entity entity : bodies) {
+      RigidBody &body = bodies.get<RigidBody>(entity);
+      if (body.InvMass() == 0.0)
+        continue;
+
+      f64 island_sleep_time = registry.get<RigidBody>(FindIsland(registry, entity))._island_sleep_time;
+      if (island_sleep_time >= SLEEP_TIME) {
+        if (body._awake)
+          body.Sleep();
+        sleeping_body_count++;
+      } else if (!body._awake) {
+        body.Wake();
+      }
     }
   }
 
@@ -360,6 +726,8 @@ namespace axl {
       modified = true;
     if (!ShowData("Is Trigger", is_trigger))
       modified = true;
+    if (!ShowData("Continuous", continuous))
+      modified = true;
 
     return modified;
   }
@@ -1,12 +1,19 @@
 #include <algorithm>
+#include <axolotl/arena.hh>
 #include <axolotl/axolotl.hh>
 #include <axolotl/camera.hh>
+#include <axolotl/cluster.hh>
 #include <axolotl/ento.hh>
 #include <axolotl/framebuffer.hh>
+#include <axolotl/geometry.hh>
+#include <axolotl/gputimer.hh>
 #include <axolotl/grid.hh>
+#include <axolotl/jobs.hh>
 #include <axolotl/material.hh>
 #include <axolotl/model.hh>
+#include <axolotl/radixsort.hh>
 #include <axolotl/renderer.hh>
+#include <axolotl/renderstate.hh>
 #include <axolotl/texture.hh>
 #include <axolotl/transform.hh>
 #include <axolotl/window.hh>
@@ -14,14 +21,128 @@
 
 namespace axl {
 
-  class Renderable {
+  enum class RenderPass { Opaque = 0, Transparent = 1 };
+
+  // Sort key, most significant first: pass | shader program | material | mesh | view depth
+  constexpr u32 SORT_KEY_PASS_BITS = 2;
+  constexpr u32 SORT_KEY_PROGRAM_BITS = 10;
+  constexpr u32 SORT_KEY_MATERIAL_BITS = 14;
+  constexpr u32 SORT_KEY_MESH_BITS = 14;
+  constexpr u32 SORT_KEY_DEPTH_BITS =
+    64 - SORT_KEY_PASS_BITS - SORT_KEY_PROGRAM_BITS - SORT_KEY_MATERIAL_BITS - SORT_KEY_MESH_BITS;
+  constexpr f32 SORT_KEY_MAX_DEPTH = 10000.0f;
+  // Renderables handed to a worker at a time while building the draw list
+  constexpr u32 DRAW_LIST_CHUNK_SIZE = 256;
+
+  static u64 SortKeyField(u64 value, u32 bits, u32 shift) {
+    return (value & ((1ull << bits) - 1)) << shift;
+  }
+
+  static u64 MakeSortKey(RenderPass pass, u32 program, u32 material, u32 mesh, f32 depth) {
+    // Opaque geometry goes front to back to make the most of early depth testing, transparent back to front
+    f32 normalized = clamp(depth / SORT_KEY_MAX_DEPTH, 0.0f, 1.0f);
+    if (pass == RenderPass::Transparent)
+      normalized = 1.0f - normalized;
+    u64 quantized = (u64)(normalized * (f32)((1u << SORT_KEY_DEPTH_BITS) - 1));
+
+    u32 shift = 0;
+    u64 key = SortKeyField(quantized, SORT_KEY_DEPTH_BITS, shift);
+    shift += SORT_KEY_DEPTH_BITS;
+    key |= SortKeyField(mesh, SORT_KEY_MESH_BITS, shift);
+    shift += SORT_KEY_MESH_BITS;
+    key |= SortKeyField(material, SORT_KEY_MATERIAL_BITS, shift);
+    shift += SORT_KEY_MATERIAL_BITS;
+    key |= SortKeyField(program, SORT_KEY_PROGRAM_BITS, shift);
+    shift += SORT_KEY_PROGRAM_BITS;
+    key |= SortKeyField((u32)pass, SORT_KEY_PASS_BITS, shift);
+    return key;
+  }
+
+  // std430 image of an Object in the shaders, instances read theirs at gl_BaseInstance + gl_InstanceID
+  class ObjectData {
+   public:
+    m4 model;
+    // Transpose of the inverse model matrix, padded to a mat4 so both layouts agree
+    m4 normal_matrix;
+  };
+
+  // One mesh of one entity, draws sharing mesh and material are merged into a single instanced call
+  class InstanceDraw {
    public:
-    Ento ento;
-    Model *model;
-    // Material *material;
-    Transform *transform;
+    u64 key;
+    Material *material;
+    Mesh *mesh;
+    ObjectData object;
   };
 
+  // Buffer bindings, match the UNIFORM_BLOCK_ and STORAGE_ defines in utils.glsl
+  constexpr u32 UNIFORM_BLOCK_LIGHTS = 0;
+  constexpr u32 UNIFORM_BLOCK_CAMERA = 1;
+  constexpr u32 STORAGE_POINT_LIGHTS = 0;
+  constexpr u32 STORAGE_CLUSTERS = 1;
+  constexpr u32 STORAGE_CLUSTER_LIGHTS = 2;
+  constexpr u32 STORAGE_OBJECTS = 3;
+
+  // std140 image of the Camera block in the shaders
+  class CameraBlock {
+   public:
+    m4 view;
+    m4 projection;
+    m4 view_projection;
+  };
+
+  // std140 image of the Lights block in the shaders, point lights and their clusters live in storage buffers
+  class LightsBlock {
+   public:
+    // xyz = clusters per axis, w = point light count
+    v4i cluster_grid;
+    v4 camera_position;
+    v4 cluster_depth;
+    v4 viewport;
+    LightData ambient;
+    LightData directional;
+  };
+  static_assert(sizeof(LightsBlock) == 64 + sizeof(LightData) * 2, "LightsBlock does not match std140");
+
+  // Orphans the previous storage, the draws still reading it are not waited on
+  static void UploadStorageBuffer(u32 buffer, u32 &capacity, const void *data, u32 size) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    if (size > capacity)
+      capacity = std::max(size, capacity * 2);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(capacity, 16u), nullptr, GL_STREAM_DRAW);
+    if (size > 0)
+      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  }
+
+  // Draws and counters built by a single worker, merged on the main thread
+  class DrawListBuffer {
+   public:
+    std::vector<InstanceDraw> draws;
+    u32 culled_count;
+    u32 submitted_count;
+    u32 mesh_count;
+    u32 vertex_count;
+    u32 triangle_count;
+  };
+
+  class SortEntry {
+   public:
+    u64 key;
+    const InstanceDraw *draw;
+  };
+
+  // Bounds of the transformed box, the world axes projected onto every model axis
+  static AABBCollider WorldBounds(const v3 &min, const v3 &max, const m4 &model) {
+    v3 center = (min + max) * 0.5f;
+    v3 half_size = (max - min) * 0.5f;
+
+    v3 extents(0.0f);
+    for (i32 i = 0; i < 3; ++i)
+      extents += abs(v3(model[i])) * half_size[i];
+    return AABBCollider(v3(model * v4(center, 1.0f)), extents);
+  }
+
   Renderer::Renderer(Window *window):
     _window(window),
     _skybox_texture(nullptr),
@@ -39,12 +160,36 @@ namespace axl {
       exit(-1);
       return;
     }
-
-    glGenBuffers(1, &_lights_uniform_buffer);
-    glBindBuffer(GL_UNIFORM_BUFFER, _lights_uniform_buffer);
-    glBufferData(GL_UNIFORM_BUFFER, (sizeof(LightData) * LIGHT_COUNT) + 32, nullptr, GL_DYNAMIC_DRAW);
+    RenderState::Invalidate();
+
+    // Blocks start on the offset alignment glBindBufferRange asks for, the camera block follows the lights one
+    i32 alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    _frame_camera_offset = ((sizeof(LightsBlock) + alignment - 1) / alignment) * alignment;
+    _frame_slot_size = ((_frame_camera_offset + sizeof(CameraBlock) + alignment - 1) / alignment) * alignment;
+    _frame_slot = 0;
+    _frame_fences.fill(nullptr);
+
+    u32 frame_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &_frame_uniform_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, _frame_uniform_buffer);
+    glBufferStorage(GL_UNIFORM_BUFFER, _frame_slot_size * FRAME_UNIFORM_SLOTS, nullptr, frame_flags);
+    _frame_mapping = (u8 *)glMapBufferRange(GL_UNIFORM_BUFFER, 0, _frame_slot_size * FRAME_UNIFORM_SLOTS, frame_flags);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
+    glGenBuffers(1, &_objects_buffer);
+    _objects_capacity = 0;
+
+    glGenBuffers(1, &_point_lights_buffer);
+    glGenBuffers(1, &_clusters_buffer);
+    glGenBuffers(1, &_cluster_lights_buffer);
+    _point_lights_capacity = 0;
+    _clusters_capacity = 0;
+    _cluster_lights_capacity = 0;
+    _light_clusters = std::make_unique<LightClusters>();
+
+    _gpu_timer = std::make_unique<GPUTimer>();
+
     _post_process_framebuffer = new FrameBuffer(_size.x, _size.y);
 
     _line_shader = std::make_unique<Shader>(
@@ -67,13 +212,27 @@ namespace axl {
     delete _post_process_shader;
     delete _post_process_framebuffer;
 
-    glDeleteBuffers(1, &_lights_uniform_buffer);
+    for (void *fence : _frame_fences)
+      if (fence)
+        glDeleteSync((GLsync)fence);
+    glBindBuffer(GL_UNIFORM_BUFFER, _frame_uniform_buffer);
+    glUnmapBuffer(GL_UNIFORM_BUFFER);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glDeleteBuffers(1, &_frame_uniform_buffer);
+    glDeleteBuffers(1, &_objects_buffer);
+    glDeleteBuffers(1, &_point_lights_buffer);
+    glDeleteBuffers(1, &_clusters_buffer);
+    glDeleteBuffers(1, &_cluster_lights_buffer);
   }
 
   const RendererPerformance &Renderer::GetPerformance() const {
     return _last_performance;
   }
 
+  const GPUTimer &Renderer::GetGPUTimer() const {
+    return *_gpu_timer;
+  }
+
   void Renderer::ClearScreen(const v3 &color) {
     glClearColor(color.x, color.y, color.z, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -113,11 +272,7 @@ namespace axl {
     m4 view(1.0f);
     m4 projection(1.0f);
 
-    u32 gl_starttime;
-    u32 gl_endtime;
-    glGenQueries(1, &gl_starttime);
-    glGenQueries(1, &gl_endtime);
-    glQueryCounter(gl_starttime, GL_TIMESTAMP);
+    _gpu_timer->BeginFrame();
 
     _performance.StartCapture(_window->GetTime());
 
@@ -126,54 +281,105 @@ namespace axl {
 
     f64 orginzation_starttime = Window::GetTime();
 
+    Frustum frustum = Frustum::FromMatrix(projection * view);
+
     entt::registry &registry = scene.GetRegistry();
-    std::vector<Renderable> renderables;
-
-    auto entities = registry.view<Model>();
-    for (auto entity : entities) {
-      Ento ento = scene.FromHandle(entity);
-      Model &model = ento.GetComponent<Model>();
-      // Material &material = ento.GetComponent<Material>();
-      Transform &transform = ento.GetComponent<Transform>();
-
-      Renderable renderable;
-      renderable.ento = ento;
-      renderable.model = &model;
-      // renderable.material = (*model._materials).begin()->second.get();
-      renderable.transform = &transform;
-      renderables.push_back(renderable);
-
-      _performance.mesh_count += model._meshes->size();
-      for (auto &mesh : *model._meshes) {
-        _performance.vertex_count += mesh->_num_vertices;
-        _performance.triangle_count += mesh->_num_indices / 3;
-      }
+    auto renderables = registry.view<Model, Transform>();
+    FrameVector<entt::entity> entities;
+    entities.reserve(renderables.size_hint());
+    for (auto entity : renderables)
+      entities.push_back(entity);
+
+    // Culling and sort keys only read the components, every worker fills its own buffer. Transforms were updated
+    // by the scene before rendering, and each entity is only visited by one worker.
+    static std::vector<DrawListBuffer> thread_buffers;
+    thread_buffers.resize(JobSystem::GetThreadCount());
+    for (DrawListBuffer &buffer : thread_buffers) {
+      buffer.draws.clear();
+      buffer.culled_count = 0;
+      buffer.submitted_count = 0;
+      buffer.mesh_count = 0;
+      buffer.vertex_count = 0;
+      buffer.triangle_count = 0;
     }
-    _performance.renderables = renderables.size();
 
-    std::sort(renderables.begin(), renderables.end(), [](const Renderable &a, const Renderable &b) {
-      return a.transform->GetPosition().z < b.transform->GetPosition().z;
+    JobSystem::ParallelFor(entities.size(), DRAW_LIST_CHUNK_SIZE, [&](u32 begin, u32 end, u32 thread_index) {
+      DrawListBuffer &buffer = thread_buffers[thread_index];
+
+      for (u32 i = begin; i < end; ++i) {
+        Model &model = renderables.get<Model>(entities[i]);
+        m4 model_mat = renderables.get<Transform>(entities[i]).GetModelMatrix();
+        f32 depth = -(view * model_mat[3]).z;
+        // Worked out once per entity instead of once per vertex
+        ObjectData object { model_mat, m4(transpose(inverse(m3(model_mat)))) };
+
+        for (Mesh *mesh : *model._meshes) {
+          auto material = model._materials->find(mesh->GetMaterialID());
+          if (material == model._materials->end())
+            continue;
+
+          if (mesh->_has_bounds && !frustum.AABBInside(WorldBounds(mesh->_bounds_min, mesh->_bounds_max, model_mat))) {
+            buffer.culled_count++;
+            continue;
+          }
+          buffer.submitted_count++;
+
+          Material *draw_material = material->second.get();
+          u64 key = MakeSortKey(RenderPass::Opaque,
+                                draw_material->GetShader().shader_id,
+                                draw_material->GetSortID(),
+                                mesh->_vao,
+                                depth);
+          buffer.draws.push_back({ key, draw_material, mesh, object });
+          buffer.vertex_count += mesh->_num_vertices;
+          buffer.triangle_count += mesh->_num_indices / 3;
+        }
+        buffer.mesh_count += model._meshes->size();
+      }
     });
+    _performance.renderables = entities.size();
+
+    // Sized up front, the arena can only take back the latest allocation so every regrowth would strand the old one
+    size_t draw_count = 0;
+    for (const DrawListBuffer &buffer : thread_buffers)
+      draw_count += buffer.draws.size();
+
+    FrameVector<SortEntry> entries;
+    entries.reserve(draw_count);
+    for (const DrawListBuffer &buffer : thread_buffers) {
+      for (const InstanceDraw &draw : buffer.draws)
+        entries.push_back({ draw.key, &draw });
+      _performance.culled_count += buffer.culled_count;
+      _performance.submitted_count += buffer.submitted_count;
+      _performance.mesh_count += buffer.mesh_count;
+      _performance.vertex_count += buffer.vertex_count;
+      _performance.triangle_count += buffer.triangle_count;
+    }
+
+    FrameVector<SortEntry> scratch;
+    RadixSort(entries, scratch);
+
+    FrameVector<InstanceDraw> draws;
+    FrameVector<ObjectData> objects;
+    draws.reserve(entries.size());
+    objects.reserve(entries.size());
+    for (const SortEntry &entry : entries) {
+      draws.push_back(*entry.draw);
+      objects.push_back(entry.draw->object);
+    }
+    _performance.instance_count = draws.size();
+
+    // Every object of the frame in a single upload
+    UploadStorageBuffer(_objects_buffer, _objects_capacity, objects.data(), objects.size() * sizeof(ObjectData));
 
     f64 orginzation_endtime = Window::GetTime();
     _performance.organization_time_accum += orginzation_endtime - orginzation_starttime;
 
     f64 lights_starttime = Window::GetTime();
-    std::vector<LightData> lights_data;
-
-    LightData ambient_light_data;
-    ambient_light_data.position = v4(1.0f);
-    ambient_light_data.color = v4(_ambient_light.color);
-    ambient_light_data.intensity = _ambient_light.intensity;
-    lights_data.push_back(ambient_light_data);
-
-    LightData directional_light_data;
-    directional_light_data.position = v4(_directional_light_direction, 0.0f);
-    directional_light_data.color = v4(_directional_light.color);
-    directional_light_data.intensity = _directional_light.intensity;
-    lights_data.push_back(directional_light_data);
+    FrameVector<LightData> point_lights;
 
     auto lights = registry.view<Light>();
+    point_lights.reserve(lights.size());
     for (auto entity : lights) {
       Ento light_ento = scene.FromHandle(entity);
       Transform &transform = light_ento.Transform();
@@ -186,71 +392,114 @@ namespace axl {
       light_data.position = position;
       light_data.color = light.color;
       light_data.intensity = light.intensity;
+      light_data.range = light.range;
+      point_lights.push_back(light_data);
+    }
 
-      if (lights.size() >= LIGHT_COUNT) {
-        log::warn("Too many lights");
-        break;
-      }
-      lights_data.push_back(light_data);
+    _light_clusters->Build(view, projection, point_lights.data(), point_lights.size());
+    const std::vector<v2u> &cluster_ranges = _light_clusters->GetRanges();
+    const std::vector<u32> &cluster_indices = _light_clusters->GetIndices();
+    UploadStorageBuffer(
+      _point_lights_buffer, _point_lights_capacity, point_lights.data(), point_lights.size() * sizeof(LightData));
+    UploadStorageBuffer(
+      _clusters_buffer, _clusters_capacity, cluster_ranges.data(), cluster_ranges.size() * sizeof(v2u));
+    UploadStorageBuffer(_cluster_lights_buffer,
+                        _cluster_lights_capacity,
+                        cluster_indices.data(),
+                        cluster_indices.size() * sizeof(u32));
+
+    // The slot was last read FRAME_UNIFORM_SLOTS frames ago, by now its fence has almost always signaled
+    GLsync fence = (GLsync)_frame_fences[_frame_slot];
+    if (fence) {
+      while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) { }
+      glDeleteSync(fence);
+      _frame_fences[_frame_slot] = nullptr;
     }
 
-    glBindBuffer(GL_UNIFORM_BUFFER, _lights_uniform_buffer);
-    i32 size = lights_data.size();
+    u32 lights_offset = _frame_slot * _frame_slot_size;
+    u32 camera_offset = lights_offset + _frame_camera_offset;
 
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, 4, &size);
+    CameraBlock &camera_block = *(CameraBlock *)(_frame_mapping + camera_offset);
+    camera_block.view = view;
+    camera_block.projection = projection;
+    camera_block.view_projection = projection * view;
 
-    glBufferSubData(GL_UNIFORM_BUFFER, 16, sizeof(v3), value_ptr(camera_transform.GetPosition()));
+    LightsBlock &block = *(LightsBlock *)(_frame_mapping + lights_offset);
+    block.cluster_grid = v4i(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, point_lights.size());
+    block.camera_position = v4(camera_transform.GetPosition(), 1.0f);
+    block.cluster_depth = _light_clusters->GetDepthParameters();
+    // Clusters are looked up from gl_FragCoord, which is relative to the framebuffer the main pass draws into
+    v2u target_size = _post_process_framebuffer->GetSize();
+    block.viewport = v4(target_size.x, target_size.y, 0.0f, 0.0f);
 
-    glBufferSubData(GL_UNIFORM_BUFFER, 32, sizeof(LightData) * lights_data.size(), lights_data.data());
-    glBufferSubData(GL_UNIFORM_BUFFER,
-                    sizeof(LightData) * lights_data.size() + 32,
-                    sizeof(LightData) * (LIGHT_COUNT - lights_data.size()),
-                    nullptr);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    block.ambient = LightData();
+    block.ambient.position = v4(1.0f);
+    block.ambient.color = v4(_ambient_light.color);
+    block.ambient.intensity = _ambient_light.intensity;
+
+    block.directional = LightData();
+    block.directional.position = v4(_directional_light_direction, 0.0f);
+    block.directional.color = v4(_directional_light.color);
+    block.directional.intensity = _directional_light.intensity;
 
     f64 lights_endtime = Window::GetTime();
     _performance.lights_time_accum += lights_endtime - lights_starttime;
 
     f64 main_draw_starttime = Window::GetTime();
+    _gpu_timer->Begin("Main");
     _post_process_framebuffer->Bind();
 
     ClearScreen(v3(0.3f));
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    if (_show_wireframe) {
-      glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    } else {
-      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    }
-    for (auto entity : renderables) {
-      m4 model_mat = entity.transform->GetModelMatrix();
-
-      // TODO: This is horrible, MAKE A RESOURCE MANAGER!
-      for (auto itr = entity.model->_materials->begin(); itr != entity.model->_materials->end(); ++itr) {
-        Material &material = *itr->second;
-        material.GetShader().Bind();
-        u32 block_index = material.GetShader().GetUniformBlockIndex("Lights");
-        material.GetShader().SetUniformBlockBinding(block_index, 0);
-        glBindBufferBase(GL_UNIFORM_BUFFER, 0, _lights_uniform_buffer);
-
-        material.GetShader().SetUniformM4((u32)UniformLocation::ModelMatrix, model_mat);
-        material.GetShader().SetUniformM4((u32)UniformLocation::ViewMatrix, view);
-        material.GetShader().SetUniformM4((u32)UniformLocation::ProjectionMatrix, projection);
+    RenderState::SetDepthTest(true);
+    RenderState::SetDepthFunc(GL_LEQUAL);
+    RenderState::SetCullFace(true);
+    RenderState::SetCullMode(GL_BACK);
+    RenderState::SetPolygonMode(_show_wireframe ? GL_LINE : GL_FILL);
+    RenderState::BindUniformBufferRange(
+      UNIFORM_BLOCK_LIGHTS, _frame_uniform_buffer, lights_offset, sizeof(LightsBlock));
+    RenderState::BindUniformBufferRange(
+      UNIFORM_BLOCK_CAMERA, _frame_uniform_buffer, camera_offset, sizeof(CameraBlock));
+    RenderState::BindStorageBuffer(STORAGE_POINT_LIGHTS, _point_lights_buffer);
+    RenderState::BindStorageBuffer(STORAGE_CLUSTERS, _clusters_buffer);
+    RenderState::BindStorageBuffer(STORAGE_CLUSTER_LIGHTS, _cluster_lights_buffer);
+    RenderState::BindStorageBuffer(STORAGE_OBJECTS, _objects_buffer);
+
+    u32 bound_program = 0;
+    Material *bound_material = nullptr;
+    for (size_t first = 0; first < draws.size();) {
+      size_t last = first + 1;
+      while (last < draws.size() && draws[last].material == draws[first].material &&
+             draws[last].mesh == draws[first].mesh)
+        last++;
+
+      if (draws[first].material != bound_material) {
+        bound_material = draws[first].material;
+        Shader &shader = bound_material->GetShader();
+
+        // Draws are sorted by program, so each one is bound once per frame. Blocks and buffers have fixed
+        // bindings in the shaders, nothing else is set per program.
+        if (shader.shader_id != bound_program) {
+          bound_program = shader.shader_id;
+          shader.Bind();
+        }
+        bound_material->BindTextures();
       }
 
-      entity.model->Draw();
+      draws[first].mesh->DrawInstanced(first, last - first);
+      first = last;
     }
 
-    if (_show_grid)
+    if (_show_grid) {
+      _gpu_timer->Begin("Grid");
       _grid->Draw(view, projection);
+      _gpu_timer->End();
+    }
 
     if (_skybox_texture) {
-      glDisable(GL_CULL_FACE);
-      glDepthFunc(GL_LEQUAL);
+      _gpu_timer->Begin("Skybox");
+      RenderState::SetCullFace(false);
+      RenderState::SetDepthFunc(GL_LEQUAL);
       _skybox_shader->Bind();
       mat4 skybox_view = mat4(mat3(view));
       _skybox_shader->SetUniformM4((u32)UniformLocation::ViewMatrix, skybox_view);
@@ -258,12 +507,12 @@ namespace axl {
 
       _skybox_texture->Bind();
       _skybox_mesh->Draw();
+      _gpu_timer->End();
     }
 
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
-
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    RenderState::SetDepthTest(false);
+    RenderState::SetCullFace(false);
+    RenderState::SetPolygonMode(GL_FILL);
 
     // Debug draw
     _line_shader->Bind();
@@ -275,12 +524,18 @@ namespace axl {
     _lines.clear();
 
     _post_process_framebuffer->Unbind();
+    _gpu_timer->End();
+
+    // Every draw reading this slot has been issued, it can be written again once they finish
+    _frame_fences[_frame_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _frame_slot = (_frame_slot + 1) % FRAME_UNIFORM_SLOTS;
 
     f64 main_draw_endtime = Window::GetTime();
     _performance.main_draw_time_accum += main_draw_endtime - main_draw_starttime;
 
     // Post process
     f64 post_draw_starttime = Window::GetTime();
+    _gpu_timer->Begin("Post");
 
     _post_process_shader->Bind();
     _post_process_shader->SetUniformM4((u32)UniformLocation::ModelMatrix, m4(1.0f));
@@ -301,21 +556,14 @@ namespace axl {
     glUniform2f(_post_process_shader->GetUniformLocation("viewport_size"), viewport_size.z, viewport_size.w);
 
     _quad_mesh->Draw();
+    _gpu_timer->End();
 
     f64 post_draw_endtime = Window::GetTime();
     _performance.post_draw_time_accum += post_draw_endtime - post_draw_starttime;
 
-    glQueryCounter(gl_endtime, GL_TIMESTAMP);
-    i32 query_available = false;
-    while (!query_available) {
-      glGetQueryObjectiv(gl_endtime, GL_QUERY_RESULT_AVAILABLE, &query_available);
-    }
-
-    u64 start_time, end_time;
-    glGetQueryObjectui64v(gl_starttime, GL_QUERY_RESULT, &start_time);
-    glGetQueryObjectui64v(gl_endtime, GL_QUERY_RESULT, &end_time);
-
-    _performance.gpu_render_time_accum += (f64)(end_time - start_time) / 1000000.0;
+    // Timings lag a few frames behind, in exchange reading them never waits on the GPU
+    _gpu_timer->EndFrame();
+    _performance.gpu_render_time_accum += _gpu_timer->GetFrameTime();
 
     f64 cpu_endtime = Window::GetTime();
     _performance.cpu_render_time_accum += cpu_endtime - cpu_starttime;
@@ -327,10 +575,14 @@ namespace axl {
   }
 
   void RendererPerformance::StartCapture(f64 now) {
+    renderables = 0;
     mesh_count = 0;
     vertex_count = 0;
     triangle_count = 0;
+    culled_count = 0;
+    submitted_count = 0;
     Mesh::_draw_calls = 0;
+    RenderState::ResetCounters();
   }
 
   void RendererPerformance::EndCapture(f64 now, f64 delta) {
@@ -364,6 +616,8 @@ namespace axl {
     }
 
     draw_calls = Mesh::_draw_calls;
+    gl_calls_issued = RenderState::GetIssuedCount();
+    gl_calls_elided = RenderState::GetElidedCount();
     delta_time_accum += delta;
     frame_count++;
   }
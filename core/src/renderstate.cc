@@ -0,0 +1,238 @@
+#include <axolotl/renderstate.hh>
+#include <glad.h>
+
+namespace axl {
+
+  static void GLUseProgram(u32 program) {
+    glUseProgram(program);
+  }
+
+  static void GLBindVertexArray(u32 vao) {
+    glBindVertexArray(vao);
+  }
+
+  static void GLActiveTexture(u32 unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+
+  static void GLBindTexture(u32 target, u32 texture) {
+    glBindTexture(target, texture);
+  }
+
+  static void GLBindBufferBase(u32 target, u32 index, u32 buffer) {
+    glBindBufferBase(target, index, buffer);
+  }
+
+  static void GLBindBufferRange(u32 target, u32 index, u32 buffer, u64 offset, u64 size) {
+    glBindBufferRange(target, index, buffer, (GLintptr)offset, (GLsizeiptr)size);
+  }
+
+  static void GLEnable(u32 capability) {
+    glEnable(capability);
+  }
+
+  static void GLDisable(u32 capability) {
+    glDisable(capability);
+  }
+
+  static void GLDepthFunc(u32 func) {
+    glDepthFunc(func);
+  }
+
+  static void GLCullFace(u32 mode) {
+    glCullFace(mode);
+  }
+
+  static void GLPolygonMode(u32 mode) {
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+  }
+
+  static GLDispatch DefaultDispatch() {
+    GLDispatch dispatch;
+    dispatch.UseProgram = GLUseProgram;
+    dispatch.BindVertexArray = GLBindVertexArray;
+    dispatch.ActiveTexture = GLActiveTexture;
+    dispatch.BindTexture = GLBindTexture;
+    dispatch.BindBufferBase = GLBindBufferBase;
+    dispatch.BindBufferRange = GLBindBufferRange;
+    dispatch.Enable = GLEnable;
+    dispatch.Disable = GLDisable;
+    dispatch.DepthFunc = GLDepthFunc;
+    dispatch.CullFace = GLCullFace;
+    dispatch.PolygonMode = GLPolygonMode;
+    return dispatch;
+  }
+
+  GLDispatch RenderState::_dispatch = DefaultDispatch();
+
+  bool RenderState::Changed(bool changed) {
+    if (changed)
+      _issued++;
+    else
+      _elided++;
+    return changed;
+  }
+
+  void RenderState::UseProgram(u32 program) {
+    if (!Changed(_program != program))
+      return;
+    _program = program;
+    _dispatch.UseProgram(program);
+  }
+
+  void RenderState::BindVertexArray(u32 vao) {
+    if (!Changed(_vao != vao))
+      return;
+    _vao = vao;
+    _dispatch.BindVertexArray(vao);
+  }
+
+  void RenderState::BindTexture(u32 unit, u32 target, u32 texture) {
+    AXL_ASSERT_MESSAGE(unit < MAX_TEXTURE_UNITS, "Texture unit {} out of range", unit);
+
+    TextureBinding &binding = _textures[unit];
+    if (!Changed(binding.target != target || binding.texture != texture))
+      return;
+
+    if (Changed(_active_unit != unit)) {
+      _active_unit = unit;
+      _dispatch.ActiveTexture(unit);
+    }
+
+    binding.target = target;
+    binding.texture = texture;
+    _dispatch.BindTexture(target, texture);
+  }
+
+  void RenderState::BindUniformBuffer(u32 index, u32 buffer) {
+    AXL_ASSERT_MESSAGE(index < MAX_UNIFORM_BUFFER_BINDINGS, "Uniform buffer binding {} out of range", index);
+
+    BufferBinding &binding = _uniform_buffers[index];
+    if (!Changed(binding.buffer != buffer || binding.offset != 0 || binding.size != 0))
+      return;
+    binding = { buffer, 0, 0 };
+    _dispatch.BindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+  }
+
+  void RenderState::BindUniformBufferRange(u32 index, u32 buffer, u64 offset, u64 size) {
+    AXL_ASSERT_MESSAGE(index < MAX_UNIFORM_BUFFER_BINDINGS, "Uniform buffer binding {} out of range", index);
+
+    BufferBinding &binding = _uniform_buffers[index];
+    if (!Changed(binding.buffer != buffer || binding.offset != offset || binding.size != size))
+      return;
+    binding = { buffer, offset, size };
+    _dispatch.BindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+  }
+
+  void RenderState::BindStorageBuffer(u32 index, u32 buffer) {
+    AXL_ASSERT_MESSAGE(index < MAX_STORAGE_BUFFER_BINDINGS, "Storage buffer binding {} out of range", index);
+
+    if (!Changed(_storage_buffers[index] != buffer))
+      return;
+    _storage_buffers[index] = buffer;
+    _dispatch.BindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+  }
+
+  void RenderState::SetDepthTest(bool enabled) {
+    if (!Changed(_depth_test != (i32)enabled))
+      return;
+    _depth_test = enabled;
+    if (enabled)
+      _dispatch.Enable(GL_DEPTH_TEST);
+    else
+      _dispatch.Disable(GL_DEPTH_TEST);
+  }
+
+  void RenderState::SetCullFace(bool enabled) {
+    if (!Changed(_cull_face != (i32)enabled))
+      return;
+    _cull_face = enabled;
+    if (enabled)
+      _dispatch.Enable(GL_CULL_FACE);
+    else
+      _dispatch.Disable(GL_CULL_FACE);
+  }
+
+  void RenderState::SetDepthFunc(u32 func) {
+    if (!Changed(_depth_func != func))
+      return;
+    _depth_func = func;
+    _dispatch.DepthFunc(func);
+  }
+
+  void RenderState::SetCullMode(u32 mode) {
+    if (!Changed(_cull_mode != mode))
+      return;
+    _cull_mode = mode;
+    _dispatch.CullFace(mode);
+  }
+
+  void RenderState::SetPolygonMode(u32 mode) {
+    if (!Changed(_polygon_mode != mode))
+      return;
+    _polygon_mode = mode;
+    _dispatch.PolygonMode(mode);
+  }
+
+  u32 RenderState::GetBoundTexture(u32 unit) {
+    if (unit >= MAX_TEXTURE_UNITS || _textures[unit].texture == RENDER_STATE_UNKNOWN)
+      return 0;
+    return _textures[unit].texture;
+  }
+
+  void RenderState::ForgetProgram(u32 program) {
+    if (_program == program)
+      _program = RENDER_STATE_UNKNOWN;
+  }
+
+  void RenderState::ForgetVertexArray(u32 vao) {
+    if (_vao == vao)
+      _vao = RENDER_STATE_UNKNOWN;
+  }
+
+  void RenderState::ForgetTexture(u32 texture) {
+    for (TextureBinding &binding : _textures)
+      if (binding.texture == texture)
+        binding = { RENDER_STATE_UNKNOWN, RENDER_STATE_UNKNOWN };
+  }
+
+  void RenderState::Invalidate() {
+    _program = RENDER_STATE_UNKNOWN;
+    _vao = RENDER_STATE_UNKNOWN;
+    _active_unit = RENDER_STATE_UNKNOWN;
+    for (TextureBinding &binding : _textures)
+      binding = { RENDER_STATE_UNKNOWN, RENDER_STATE_UNKNOWN };
+    for (BufferBinding &binding : _uniform_buffers)
+      binding = { RENDER_STATE_UNKNOWN, 0, 0 };
+    for (u32 &buffer : _storage_buffers)
+      buffer = RENDER_STATE_UNKNOWN;
+    _depth_test = -1;
+    _cull_face = -1;
+    _depth_func = RENDER_STATE_UNKNOWN;
+    _cull_mode = RENDER_STATE_UNKNOWN;
+    _polygon_mode = RENDER_STATE_UNKNOWN;
+  }
+
+  void RenderState::ResetCounters() {
+    _issued = 0;
+    _elided = 0;
+  }
+
+  u32 RenderState::GetIssuedCount() {
+    return _issued;
+  }
+
+  u32 RenderState::GetElidedCount() {
+    return _elided;
+  }
+
+  void RenderState::SetDispatch(const GLDispatch &dispatch) {
+    _dispatch = dispatch;
+    Invalidate();
+  }
+
+  void RenderState::ResetDispatch() {
+    SetDispatch(DefaultDispatch());
+  }
+
+} // namespace axl
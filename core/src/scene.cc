@@ -1,4 +1,5 @@
 #include <axolotl/axolotl.hh>
+#include <axolotl/binary.hh>
 #include <axolotl/camera.hh>
 #include <axolotl/ento.hh>
 #include <axolotl/material.hh>
@@ -10,11 +11,23 @@
 #include <axolotl/shader.hh>
 #include <axolotl/transform.hh>
 #include <iostream>
+#include <unordered_map>
 
 namespace axl {
 
+  // "AXLS", bumped whenever the layout below changes
+  constexpr u32 SCENE_BINARY_MAGIC = 0x534c5841;
+  constexpr u32 SCENE_BINARY_VERSION = 1;
+
+  // Model paths inside the dist directory are stored relative to it
+  static std::string ToPortablePath(std::string path) {
+    std::string dist_dir = Axolotl::GetDistDir();
+    if (path.find(dist_dir) == 0)
+      path.replace(0, dist_dir.size(), "${DistDir}");
+    return path;
+  }
+
   void Scene::SetActiveScene(Scene *scene) {
-    Ento::ClearMaps();
     new_scene = true;
     _active_scene = scene;
   }
@@ -27,8 +40,9 @@ namespace axl {
     Tag &tag = e.AddComponent<Tag>();
     name.empty() ? tag.value = Tag::DefaultTag : tag.value = name;
 
-    Ento::_uuid_ento_map.insert(std::make_pair(e.id, e));
-    Ento::_handle_ento_map.insert(std::make_pair(e.handle, e));
+    _uuid_index.Insert(e.id, e.handle);
+    _handle_index.Insert(e.handle, e.id);
+    _transform_hierarchy.Invalidate();
 
     log::debug("Created ento {}", uuids::to_string(e.id));
 
@@ -48,25 +62,40 @@ namespace axl {
     if (e.HasParent())
       e.Parent().RemoveChild(e);
 
-    Ento::_uuid_ento_map.erase(e.id);
-    Ento::_handle_ento_map.erase(e.handle);
+    _uuid_index.Erase(e.id);
+    _handle_index.Erase(e.handle);
+    _transform_hierarchy.Invalidate();
 
     _registry.destroy(e.handle);
     log::debug("Removed entity with id {}", uuids::to_string(e.id));
   }
 
   Ento Scene::FromID(uuid id) {
-    if (!Ento::_uuid_ento_map.count(id))
+    entt::entity handle = _uuid_index.Find(id);
+    if (handle == entt::null)
       return {};
 
-    return Ento::_uuid_ento_map[id];
+    Ento e;
+    e.handle = handle;
+    e.scene = this;
+    e.id = id;
+    return e;
   }
 
   Ento Scene::FromHandle(entt::entity handle) {
-    if (!Ento::_handle_ento_map.count(handle))
+    const uuid *id = _handle_index.Find(handle);
+    if (!id)
       return {};
 
-    return Ento::_handle_ento_map[handle];
+    Ento e;
+    e.handle = handle;
+    e.scene = this;
+    e.id = *id;
+    return e;
+  }
+
+  void Scene::UpdateTransforms() {
+    _transform_hierarchy.Update(_registry, _uuid_index);
   }
 
   void Scene::PhysicsUpdate(f64 step) {
@@ -82,6 +111,7 @@ namespace axl {
     if (!camera_transform)
       camera_transform = &Ento::FromComponent(*camera).GetComponent<Transform>();
 
+    UpdateTransforms();
     renderer.Render(*this, show_data, focused, *camera, *camera_transform);
   }
 
@@ -93,80 +123,113 @@ namespace axl {
     return _registry;
   }
 
+  Broadphase &Scene::GetBroadphase() {
+    return _broadphase;
+  }
+
+  ContactCache &Scene::GetContactCache() {
+    return _contacts;
+  }
+
+  PhysicsWorld &Scene::GetPhysicsWorld() {
+    return _physics_world;
+  }
+
+  // Pool oriented layout: "ids" holds every entity uuid once, each entry of "pools" lists the indices of its
+  // entities into "ids" and one array per member, in the same order.
   json Scene::Serialize() {
     using namespace entt::literals;
 
+    struct Column {
+      entt::meta_data data;
+      std::string name;
+      bool portable_path;
+      bool valid;
+      json values;
+    };
+
     json j;
+    json &ids = j["ids"] = json::array();
+    json &pools = j["pools"] = json::array();
 
+    std::vector<u32> entity_indices;
     _registry.each([&](entt::entity entity) {
-      json e;
-      e["id"] = FromHandle(entity).id;
-      e["components"] = {};
-
-      for (auto [id, pool] : _registry.storage()) {
-        // TODO: Rework how componenets are thought of. In the current system, it is represented as
-        // Entity => [Component...], but it should be represented as Component => [Entity...]. And in the
-        // deserialization, it should all be tight up. It is called a Pool for a reason...
-        if (!pool.contains(entity))
-          continue;
+      auto index = entt::to_entity(entity);
+      if (index >= entity_indices.size())
+        entity_indices.resize(index + 1);
+      entity_indices[index] = ids.size();
+      ids.push_back(FromHandle(entity).id);
+    });
 
-        json c = {};
-        auto meta = entt::resolve(id);
-        if (!meta) {
+    std::vector<Column> columns;
+    for (auto [id, pool] : _registry.storage()) {
+      if (pool.empty())
+        continue;
+
+      auto meta = entt::resolve(id);
+      if (!meta) {
 #ifdef AXOLOTL_DEBUG
-          log::error("Could not resolve meta for type {}", id);
+        log::error("Could not resolve meta for type {}", id);
 #endif
-          continue;
-        }
-        std::string component_name = meta.prop("name"_hs).value().cast<std::string>();
-        auto handle = meta.func("get"_hs).invoke({}, entt::forward_as_meta(_registry), entity);
+        continue;
+      }
+      std::string component_name = meta.prop("name"_hs).value().cast<std::string>();
+      entt::meta_func get = meta.func("get"_hs);
+
+      columns.clear();
+      for (entt::meta_data data : meta.data()) {
+        std::string name = data.prop("name"_hs).value().cast<std::string>();
+        bool portable_path = component_name == "Model" && name == "_path";
+        columns.push_back({ data, name, portable_path, true, json::array() });
+      }
 
-        c["data"] = {};
-        c["type"] = component_name;
-        c["id"] = id;
-        for (entt::meta_data data : handle.type().data()) {
-          std::string name = data.prop("name"_hs).value().cast<std::string>();
-          auto member = data.get(handle);
+      json p;
+      p["type"] = component_name;
+      p["id"] = id;
+      json &entities = p["entities"] = json::array();
+
+      for (entt::entity entity : pool) {
+        entities.push_back(entity_indices[entt::to_entity(entity)]);
+        auto handle = get.invoke({}, entt::forward_as_meta(_registry), entity);
+
+        for (Column &column : columns) {
+          if (!column.valid)
+            continue;
+
+          auto member = column.data.get(handle);
           member.allow_cast<json>();
           json *member_values = member.try_cast<json>();
           if (!member_values) {
 #ifdef AXOLOTL_DEBUG
             log::error("Could not convert to json {} | {} inside {}",
-                       data.type().info().name(),
-                       name,
-                       handle.type().info().name());
+                       column.data.type().info().name(),
+                       column.name,
+                       component_name);
 #endif
+            column.valid = false;
             continue;
           }
 
-          json mj = {};
-          mj["name"] = name;
-
-          if (component_name == "Model" && name == "_path") {
-            std::string dist_dir = Axolotl::GetDistDir();
-            std::string model_path = member_values->get<std::string>();
-
-            // if model_path starts with dist_dir replace with ${DistDir}
-            if (model_path.find(dist_dir) == 0)
-              model_path.replace(0, dist_dir.size(), "${DistDir}");
-
-            mj["data"] = model_path;
-          } else {
-            mj["data"] = *member_values;
-          }
-
-          c["data"].push_back(mj);
+          if (column.portable_path)
+            column.values.push_back(ToPortablePath(member_values->get<std::string>()));
+          else
+            column.values.push_back(std::move(*member_values));
         }
-        e["components"].push_back(c);
       }
 
-      j["entities"].push_back(e);
-    });
+      json &data = p["data"] = json::object();
+      for (Column &column : columns)
+        if (column.valid)
+          data[column.name] = std::move(column.values);
+
+      pools.push_back(std::move(p));
+    }
+
     return j;
   }
 
-  void Scene::Deserialize(const json &j) {
-    std::vector<Texture2D> textures_tmp;
+  void Scene::ClearForLoad(std::vector<Texture2D> &textures_tmp) {
+    // Hold on to every loaded texture, so the ones the new scene uses are not freed and reloaded
     for (auto itr = TextureStore::_data.begin(); itr != TextureStore::_data.end(); itr++) {
       Texture2D texture;
       texture.texture_id = itr->first;
@@ -183,19 +246,104 @@ namespace axl {
     for (Ento &ento : to_destroy)
       RemoveEntity(ento);
 
-    Ento::_uuid_ento_map.clear();
-    Ento::_handle_ento_map.clear();
+    _uuid_index.Clear();
+    _handle_index.Clear();
+    _transform_hierarchy.Invalidate();
     _registry = entt::registry();
+    _broadphase.Clear();
+    _contacts.Clear();
+  }
+
+  void Scene::InitComponents() {
+    using namespace entt::literals;
+
+    for (auto [id, pool] : _registry.storage()) {
+      for (auto entity : pool) {
+        auto meta = entt::resolve(id);
+        if (!meta) {
+#ifdef AXOLOTL_DEBUG
+          log::error("Could not resolve meta for type {}", meta.info().name());
+#endif
+          return;
+        }
+        auto handle = meta.func("get"_hs).invoke({}, entt::forward_as_meta(_registry), entity);
+        meta.func("Init"_hs).invoke(handle);
+      }
+    }
+  }
+
+  void Scene::Deserialize(const json &j) {
+    std::vector<Texture2D> textures_tmp;
+    ClearForLoad(textures_tmp);
+
+    if (!j.contains("pools"))
+      DeserializeEntities(j);
+    else
+      DeserializePools(j);
+
+    InitComponents();
+  }
+
+  void Scene::DeserializePools(const json &j) {
+    using namespace entt::literals;
+
+    const json &ids = j["ids"];
+    std::vector<entt::entity> entities(ids.size());
+    _registry.create(entities.begin(), entities.end());
+    for (size_t i = 0; i < entities.size(); ++i) {
+      uuid id = ids[i];
+      _uuid_index.Insert(id, entities[i]);
+      _handle_index.Insert(entities[i], id);
+    }
+
+    std::vector<entt::meta_any> handles;
+    for (const json &p : j["pools"]) {
+      auto meta = entt::resolve(p["id"].get<entt::id_type>());
+      if (!meta) {
+#ifdef AXOLOTL_DEBUG
+        log::error("Skipping unknown component pool {}", p["type"].get<std::string>());
+#endif
+        continue;
+      }
 
+      // Emplace the whole pool first, the member columns then fill it in
+      entt::meta_func emplace = meta.func("emplace"_hs);
+      handles.clear();
+      for (const json &index : p["entities"]) {
+        u32 i = index;
+        if (i >= entities.size()) {
+          log::error("Component {} references entity {} out of {}", p["type"].get<std::string>(), i, entities.size());
+          continue;
+        }
+        handles.push_back(emplace.invoke({}, entt::forward_as_meta(_registry), entities[i]));
+      }
+
+      const json &data = p["data"];
+      for (entt::meta_data d : meta.data()) {
+        auto column = data.find(d.prop("name"_hs).value().cast<std::string>());
+        if (column == data.end() || column->size() != handles.size())
+          continue;
+
+        entt::meta_func from_json = d.type().func("FromJSON"_hs);
+        for (size_t i = 0; i < handles.size(); ++i) {
+          auto member = d.get(handles[i]);
+          from_json.invoke({}, entt::forward_as_meta((*column)[i]), member.as_ref());
+          d.set(handles[i], member);
+        }
+      }
+    }
+  }
+
+  // Entity => [Component...] layout written before the pool oriented one, kept so older scenes still load
+  void Scene::DeserializeEntities(const json &j) {
     using namespace entt::literals;
 
+    std::unordered_map<entt::id_type, std::vector<std::pair<entt::meta_data, std::string>>> members;
     for (auto &e : j["entities"]) {
       entt::entity entity = _registry.create();
-      Ento ento(entity, this);
       uuid id = e["id"];
-      ento.id = id;
-      Ento::_uuid_ento_map.insert(std::make_pair(id, ento));
-      Ento::_handle_ento_map.insert(std::make_pair(entity, ento));
+      _uuid_index.Insert(id, entity);
+      _handle_index.Insert(entity, id);
 
       for (auto &c : e["components"]) {
         if (!c.contains("id")) {
@@ -204,42 +352,238 @@ namespace axl {
 #endif
           continue;
         }
-        auto meta = entt::resolve(c["id"].get<entt::id_type>());
-        auto handle = meta.func("emplace"_hs).invoke({}, entt::forward_as_meta(_registry), entity);
+        entt::id_type type_id = c["id"].get<entt::id_type>();
+        auto meta = entt::resolve(type_id);
+        if (!meta)
+          continue;
+
+        auto names = members.find(type_id);
+        if (names == members.end()) {
+          names = members.emplace(type_id, std::vector<std::pair<entt::meta_data, std::string>>()).first;
+          for (auto d : meta.data())
+            names->second.emplace_back(d, d.prop("name"_hs).value().cast<std::string>());
+        }
 
-        for (auto d : meta.data()) {
-          const std::string name = d.prop("name"_hs).value().cast<std::string>();
-          bool found = false;
-          for (auto dj : c["data"]) {
+        auto handle = meta.func("emplace"_hs).invoke({}, entt::forward_as_meta(_registry), entity);
+        for (auto &dj : c["data"]) {
+          for (auto &[d, name] : names->second) {
             if (dj["name"] != name)
               continue;
-            found = true;
 
             auto member = d.get(handle);
             d.type().func("FromJSON"_hs).invoke({}, entt::forward_as_meta(dj["data"]), member.as_ref());
             d.set(handle, member);
             break;
           }
-          if (!found) {
-            // log::error("Could not find data {} in component {}", name, c["type"]);
-          }
         }
       }
     }
+  }
 
+  // Layout, native byte order:
+  //   u32 magic, u32 version, u32 entity count, u32 pool count
+  //   uuid per entity, the position in this table is the entity index used below
+  //   per pool: id_type id, i32 component hash, u32 component count, u32 member count, u64 pool byte size
+  //             u32 entity index per component
+  //             per member: id_type member id, u64 column byte size, then the member of every component
+  // Pools and members carry their sizes, so unknown ones are skipped instead of failing the whole load.
+  std::vector<u8> Scene::SerializeBinary() {
+    using namespace entt::literals;
+
+    BinaryWriter writer;
+
+    std::vector<u32> entity_indices;
+    std::vector<uuid> entity_ids;
+    _registry.each([&](entt::entity entity) {
+      auto index = entt::to_entity(entity);
+      if (index >= entity_indices.size())
+        entity_indices.resize(index + 1);
+      entity_indices[index] = entity_ids.size();
+      entity_ids.push_back(FromHandle(entity).id);
+    });
+
+    writer.Write(SCENE_BINARY_MAGIC);
+    writer.Write(SCENE_BINARY_VERSION);
+    writer.Write((u32)entity_ids.size());
+    size_t pool_count_offset = writer.Reserve<u32>();
+    for (const uuid &id : entity_ids)
+      writer.Write(id);
+
+    u32 pool_count = 0;
     for (auto [id, pool] : _registry.storage()) {
-      for (auto entity : pool) {
-        auto meta = entt::resolve(id);
-        if (!meta) {
+      auto meta = entt::resolve(id);
+      if (!meta || pool.empty())
+        continue;
+
+      std::string component_name = meta.prop("name"_hs).value().cast<std::string>();
+      i32 component_hash = meta.func("GetHash"_hs).invoke({}).cast<i32>();
+      entt::meta_func get = meta.func("get"_hs);
+
+      u32 member_count = 0;
+      for (entt::meta_data data : meta.data())
+        if (data.type().func("ToBinary"_hs))
+          member_count++;
+
+      writer.Write(id);
+      writer.Write(component_hash);
+      writer.Write((u32)pool.size());
+      writer.Write(member_count);
+      size_t pool_size_offset = writer.Reserve<u64>();
+      size_t pool_start = writer.buffer.size();
+
+      for (entt::entity entity : pool)
+        writer.Write(entity_indices[entt::to_entity(entity)]);
+
+      for (entt::meta_data data : meta.data()) {
+        entt::meta_func to_binary = data.type().func("ToBinary"_hs);
+        if (!to_binary)
+          continue;
+
+        std::string name = data.prop("name"_hs).value().cast<std::string>();
+        bool portable_path = component_name == "Model" && name == "_path";
+
+        writer.Write(data.id());
+        size_t column_size_offset = writer.Reserve<u64>();
+        size_t column_start = writer.buffer.size();
+
+        for (entt::entity entity : pool) {
+          auto handle = get.invoke({}, entt::forward_as_meta(_registry), entity);
+          auto member = data.get(handle);
+
+          if (portable_path)
+            writer.Write(ToPortablePath(member.cast<std::filesystem::path>().string()));
+          else
+            to_binary.invoke({}, entt::forward_as_meta(writer), member.as_ref());
+        }
+
+        writer.Patch<u64>(column_size_offset, writer.buffer.size() - column_start);
+      }
+
+      writer.Patch<u64>(pool_size_offset, writer.buffer.size() - pool_start);
+      pool_count++;
+    }
+
+    writer.Patch(pool_count_offset, pool_count);
+    return std::move(writer.buffer);
+  }
+
+  bool Scene::DeserializeBinary(const std::filesystem::path &path) {
+    using namespace entt::literals;
+
+    MappedFile file(path);
+    if (!file)
+      return false;
+
+    BinaryReader reader(file.GetData(), file.GetSize());
+
+    u32 magic = 0;
+    u32 version = 0;
+    u32 entity_count = 0;
+    u32 pool_count = 0;
+    reader.Read(magic);
+    reader.Read(version);
+    reader.Read(entity_count);
+    reader.Read(pool_count);
+
+    if (reader.Failed() || magic != SCENE_BINARY_MAGIC) {
+      log::error("{} is not a binary scene", path.string());
+      return false;
+    }
+    if (version != SCENE_BINARY_VERSION) {
+      log::error("Binary scene {} has version {}, expected {}", path.string(), version, SCENE_BINARY_VERSION);
+      return false;
+    }
+    if ((u64)entity_count * sizeof(uuid) > file.GetSize()) {
+      log::error("Binary scene {} is corrupt", path.string());
+      return false;
+    }
+
+    std::vector<Texture2D> textures_tmp;
+    ClearForLoad(textures_tmp);
+
+    std::vector<entt::entity> entities(entity_count);
+    _registry.create(entities.begin(), entities.end());
+    for (entt::entity entity : entities) {
+      uuid id;
+      reader.Read(id);
+      _uuid_index.Insert(id, entity);
+      _handle_index.Insert(entity, id);
+    }
+
+    std::vector<u32> indices;
+    for (u32 p = 0; p < pool_count && !reader.Failed(); ++p) {
+      entt::id_type id = 0;
+      i32 component_hash = 0;
+      u32 count = 0;
+      u32 member_count = 0;
+      u64 pool_size = 0;
+      reader.Read(id);
+      reader.Read(component_hash);
+      reader.Read(count);
+      reader.Read(member_count);
+      reader.Read(pool_size);
+      size_t pool_end = reader.Tell() + pool_size;
+
+      auto meta = entt::resolve(id);
+      if (!meta) {
 #ifdef AXOLOTL_DEBUG
-          log::error("Could not resolve meta for type {}", meta.info().name());
+        log::error("Skipping unknown component pool {}", id);
 #endif
-          return;
+        reader.Seek(pool_end);
+        continue;
+      }
+#ifdef AXOLOTL_DEBUG
+      if (component_hash != meta.func("GetHash"_hs).invoke({}).cast<i32>())
+        log::warn("Component {} changed since the scene was saved, loading matching members only",
+                  meta.prop("name"_hs).value().cast<std::string>());
+#endif
+
+      // Construct the whole pool up front, the member columns then fill it in
+      entt::meta_func emplace = meta.func("emplace"_hs);
+      indices.resize(count);
+      std::vector<entt::meta_any> handles;
+      handles.reserve(count);
+      for (u32 i = 0; i < count; ++i) {
+        reader.Read(indices[i]);
+        if (indices[i] >= entity_count) {
+          reader.Seek(file.GetSize() + 1);
+          break;
         }
-        auto handle = meta.func("get"_hs).invoke({}, entt::forward_as_meta(_registry), entity);
-        meta.func("Init"_hs).invoke(handle);
+        handles.push_back(emplace.invoke({}, entt::forward_as_meta(_registry), entities[indices[i]]));
+      }
+
+      for (u32 m = 0; m < member_count && !reader.Failed(); ++m) {
+        entt::id_type member_id = 0;
+        u64 column_size = 0;
+        reader.Read(member_id);
+        reader.Read(column_size);
+        size_t column_end = reader.Tell() + column_size;
+
+        entt::meta_data data = meta.data(member_id);
+        entt::meta_func from_binary = data ? data.type().func("FromBinary"_hs) : entt::meta_func();
+        if (!from_binary) {
+          reader.Seek(column_end);
+          continue;
+        }
+
+        for (auto &handle : handles) {
+          auto member = data.get(handle);
+          from_binary.invoke({}, entt::forward_as_meta(reader), member.as_ref());
+          data.set(handle, member);
+        }
+
+        if (reader.Tell() != column_end)
+          reader.Seek(file.GetSize() + 1);
       }
+
+      reader.Seek(pool_end);
     }
+
+    if (reader.Failed())
+      log::error("Binary scene {} is truncated or corrupt, the scene may be incomplete", path.string());
+
+    InitComponents();
+    return !reader.Failed();
   }
 
 } // namespace axl
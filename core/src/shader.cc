@@ -1,4 +1,5 @@
 #include <axolotl/axolotl.hh>
+#include <axolotl/renderstate.hh>
 #include <axolotl/shader.hh>
 #include <axolotl/texture.hh>
 #include <efsw/efsw.hpp>
@@ -154,11 +155,11 @@ namespace axl {
   void Shader::Bind() {
     ShaderData &data = ShaderStore::GetData(shader_id);
     AXL_ASSERT_MESSAGE(data.gl_id, "Shader program {} not compiled", data.gl_id);
-    glUseProgram(data.gl_id);
+    RenderState::UseProgram(data.gl_id);
   }
 
   void Shader::Unbind() {
-    glUseProgram(0);
+    RenderState::UseProgram(0);
   }
 
   void Shader::UnloadShader(ShaderType type) {
@@ -282,6 +283,7 @@ namespace axl {
       glDeleteShader(_shader_data[shader_id].shaders[i]);
     }
 
+    RenderState::ForgetProgram(_shader_data[shader_id].gl_id);
     glDeleteProgram(_shader_data[shader_id].gl_id);
 
     for (i32 i = 0; i < (i32)ShaderType::Last; ++i) {
@@ -511,6 +513,7 @@ namespace axl {
       return false;
     }
 
+    RenderState::ForgetProgram(data.gl_id);
     glDeleteProgram(data.gl_id);
     data.gl_id = 0;
 
@@ -858,16 +861,7 @@ namespace axl {
     i32 location = (i32)UniformLocation::Textures + (i32)type;
     glUniform1i(location, unit);
 
-    i32 active_texture;
-    glGetIntegerv(GL_ACTIVE_TEXTURE, &active_texture);
-
-    glActiveTexture(GL_TEXTURE0 + unit);
-    i32 value;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
-
-    data._uniform_textures[(i32)UniformLocation::Textures][(i32)type] = value;
-
-    glActiveTexture(active_texture);
+    data._uniform_textures[(i32)UniformLocation::Textures][(i32)type] = RenderState::GetBoundTexture(unit);
   }
 
   u32 Shader::GetUniformBlockIndex(const std::string &name) {
@@ -1,3 +1,4 @@
+#include <axolotl/renderstate.hh>
 #include <axolotl/texture.hh>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -31,8 +32,7 @@ namespace axl {
   }
 
   void TextureCube::Bind() {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, TextureStore::GetRendererID(texture_id));
+    RenderState::BindTexture(0, GL_TEXTURE_CUBE_MAP, TextureStore::GetRendererID(texture_id));
   }
 
   Texture2D::Texture2D(const std::filesystem::path &path, TextureType type, const TextureData &data): type(type) {
@@ -84,8 +84,7 @@ namespace axl {
   }
 
   void Texture2D::Bind(u32 unit) {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, TextureStore::GetRendererID(texture_id));
+    RenderState::BindTexture(unit, GL_TEXTURE_2D, TextureStore::GetRendererID(texture_id));
   }
 
   u32 TextureStore::GetTextureID(const std::filesystem::path &path) {
@@ -185,7 +184,7 @@ namespace axl {
     paths.push_back(std::filesystem::path(path.string() + "_front.jpg"));
 
     glGenTextures(1, &_data[texture.texture_id].gl_id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _data[texture.texture_id].gl_id);
+    RenderState::BindTexture(0, GL_TEXTURE_CUBE_MAP, _data[texture.texture_id].gl_id);
 
     stbi_set_flip_vertically_on_load(false);
     for (u32 i = 0; i < 6; i++) {
@@ -226,14 +225,14 @@ namespace axl {
 
     u32 tex;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    RenderState::BindTexture(0, GL_TEXTURE_2D, tex);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    RenderState::BindTexture(0, GL_TEXTURE_2D, 0);
 
     _data[texture.texture_id].gl_id = tex;
     _data[texture.texture_id].size = v2i(width, height);
@@ -327,14 +326,14 @@ namespace axl {
 
     u32 tex;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    RenderState::BindTexture(0, GL_TEXTURE_2D, tex);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexImage2D(GL_TEXTURE_2D, 0, format, data.size.x, data.size.y, 0, internal_format, type, nullptr);
     glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    RenderState::BindTexture(0, GL_TEXTURE_2D, 0);
 
     _data[texture.texture_id].gl_id = tex;
     _data[texture.texture_id].loaded = true;
@@ -368,8 +367,10 @@ namespace axl {
 
     log::debug("Deleting Texture \"{}\"", GetPath(id).string());
 
-    if (_data[id].gl_id != 0)
+    if (_data[id].gl_id != 0) {
+      RenderState::ForgetTexture(_data[id].gl_id);
       glDeleteTextures(1, &_data[id].gl_id);
+    }
 
     _data.erase(id);
     _path_to_id.erase(GetPath(id));
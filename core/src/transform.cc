@@ -1,6 +1,4 @@
 #include <axolotl/component.hh>
-#include <axolotl/ento.hh>
-#include <axolotl/scene.hh>
 #include <axolotl/transform.hh>
 #include <imgui.h>
 
@@ -57,44 +55,25 @@ namespace axl {
   }
 
   bool Transform::IsDirty() const {
-    if (_is_dirty)
-      return true;
-
-    Ento ento = Ento::FromComponent(*this);
-    if (!ento.HasParent())
-      return _is_dirty;
-
-    return ento.Parent().Transform()._model_matrix != _parent_model_matrix;
+    return _is_dirty;
   }
 
-  m4 Transform::GetModelMatrix() {
-    Ento ento = Ento::FromComponent(*this);
-
-    if (!IsDirty()) {
-      if (!ento.HasParent())
-        return _model_matrix;
-
-      if (!ento.Parent().Transform().IsDirty())
-        return _model_matrix;
-    }
-
+  m4 Transform::GetLocalMatrix() const {
     m4 model(1.0f);
     model = translate(model, _position);
     model *= toMat4(_rotation);
     model = scale(model, _scale);
-
-    if (ento.HasParent() && ento.Parent()) {
-      Ento parent = ento.Parent();
-      _parent_model_matrix = parent.Transform().GetModelMatrix();
-      model = _parent_model_matrix * model;
-    }
-
-    _model_matrix = model;
-    _is_dirty = false;
-    _was_dirty = true;
     return model;
   }
 
+  m4 Transform::GetModelMatrix() {
+    // TransformHierarchy::Update keeps this cached, only transforms touched since the last pass are rebuilt
+    // here, against the parent matrix of that pass.
+    if (_is_dirty)
+      _model_matrix = _parent_model_matrix * GetLocalMatrix();
+    return _model_matrix;
+  }
+
   m4 Transform::GetParentModelMatrix() {
     return _parent_model_matrix;
   }
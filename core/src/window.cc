@@ -1,4 +1,5 @@
 #include <GLFW/glfw3.h>
+#include <axolotl/arena.hh>
 #include <axolotl/gui.hh>
 #include <axolotl/renderer.hh>
 #include <axolotl/window.hh>
@@ -72,6 +73,8 @@ namespace axl {
   void Window::Draw() {
     _gui->Draw();
     glfwSwapBuffers(_window);
+    // Nothing allocated from the frame arena survives past this point
+    Arena::GetFrameArena().Reset();
   }
 
   Renderer &Window::GetRenderer() const {
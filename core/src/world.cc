@@ -0,0 +1,181 @@
+#include <axolotl/ento.hh>
+#include <axolotl/geometry.hh>
+#include <axolotl/physics.hh>
+#include <axolotl/simd.hh>
+#include <axolotl/transform.hh>
+#include <axolotl/world.hh>
+
+namespace axl {
+
+  // Velocities below this are snapped to zero
+  constexpr f32 REST_VELOCITY = 0.001f;
+
+  // velocity = (velocity + acceleration * step) * damping, snapping tiny values to zero
+  static void IntegrateVelocityLanes(f32 *velocity, const f32 *acceleration, u32 count, f32 step) {
+    const f32 damping = (f32)RigidBody::damping;
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    const __m256 step_8 = _mm256_set1_ps(step);
+    const __m256 damping_8 = _mm256_set1_ps(damping);
+    const __m256 rest_8 = _mm256_set1_ps(REST_VELOCITY);
+    const __m256 abs_mask_8 = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    for (; i + 8 <= count; i += 8) {
+      __m256 v = _mm256_loadu_ps(velocity + i);
+      v = _mm256_mul_ps(_mm256_add_ps(v, _mm256_mul_ps(_mm256_loadu_ps(acceleration + i), step_8)), damping_8);
+      __m256 moving = _mm256_cmp_ps(_mm256_and_ps(v, abs_mask_8), rest_8, _CMP_GE_OQ);
+      _mm256_storeu_ps(velocity + i, _mm256_and_ps(v, moving));
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    const __m128 step_4 = _mm_set1_ps(step);
+    const __m128 damping_4 = _mm_set1_ps(damping);
+    const __m128 rest_4 = _mm_set1_ps(REST_VELOCITY);
+    const __m128 abs_mask_4 = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    for (; i + 4 <= count; i += 4) {
+      __m128 v = _mm_loadu_ps(velocity + i);
+      v = _mm_mul_ps(_mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(acceleration + i), step_4)), damping_4);
+      __m128 moving = _mm_cmpge_ps(_mm_and_ps(v, abs_mask_4), rest_4);
+      _mm_storeu_ps(velocity + i, _mm_and_ps(v, moving));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      f32 v = (velocity[i] + acceleration[i] * step) * damping;
+      velocity[i] = abs(v) < REST_VELOCITY ? 0.0f : v;
+    }
+  }
+
+  // position += velocity * step
+  static void IntegratePositionLanes(f32 *position, const f32 *velocity, u32 count, f32 step) {
+    u32 i = 0;
+
+#if defined(AXL_SIMD_AVX)
+    const __m256 step_8 = _mm256_set1_ps(step);
+    for (; i + 8 <= count; i += 8) {
+      __m256 p = _mm256_add_ps(_mm256_loadu_ps(position + i), _mm256_mul_ps(_mm256_loadu_ps(velocity + i), step_8));
+      _mm256_storeu_ps(position + i, p);
+    }
+#endif
+
+#if defined(AXL_SIMD_SSE)
+    const __m128 step_4 = _mm_set1_ps(step);
+    for (; i + 4 <= count; i += 4) {
+      __m128 p = _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(_mm_loadu_ps(velocity + i), step_4));
+      _mm_storeu_ps(position + i, p);
+    }
+#endif
+
+    for (; i < count; ++i)
+      position[i] += velocity[i] * step;
+  }
+
+  void PhysicsWorld::Resize(u32 count) {
+    _count = count;
+    // Padding lanes stay zeroed, so they integrate to zero and never need masking
+    u32 padded = SIMDPadded(count);
+
+    _entities.resize(count);
+    _angular.resize(count);
+    for (i32 i = 0; i < 3; ++i) {
+      _position[i].assign(padded, 0.0f);
+      _velocity[i].assign(padded, 0.0f);
+      _acceleration[i].assign(padded, 0.0f);
+      _angular_velocity[i].assign(padded, 0.0f);
+      _angular_acceleration[i].assign(padded, 0.0f);
+    }
+  }
+
+  u32 PhysicsWorld::GetBodyCount() const {
+    return _count;
+  }
+
+  void PhysicsWorld::Gather(entt::registry &registry) {
+    auto group = registry.group<Transform, RigidBody>();
+    Resize(group.size());
+
+    const v3 gravity(0.0f, -GRAVITATIONAL_CONSTANT, 0.0f);
+
+    u32 i = 0;
+    group.each([&](entt::entity entity, Transform &transform, RigidBody &body) {
+      body.colliding_with.clear();
+
+      // Sleeping bodies rest with zeroed velocities, anything else was set from outside since the last step
+      if (!body.IsAwake() && (body.velocity != v3(0.0f) || body.angular_velocity != v3(0.0f)))
+        body.Wake();
+      if (!body.IsAwake() && body.InvMass() != 0.0)
+        return;
+
+      // Gravity is applied in the parent space, only children pay for the matrix decomposition
+      const HierarchyComponent *hierarchy = registry.try_get<HierarchyComponent>(entity);
+      if (hierarchy && !hierarchy->parent.is_nil())
+        body.forces = conjugate(quat_cast(transform.GetParentModelMatrix())) * gravity * (f32)body.mass;
+      else
+        body.forces = gravity * (f32)body.mass;
+
+      const OBBCollider *obb = registry.try_get<OBBCollider>(entity);
+      body.UpdateInertia(registry.try_get<SphereCollider>(entity), obb);
+
+      v3 acceleration = body.forces * (f32)body.InvMass();
+      v3 angular_acceleration = body.torques * body.InvTensor();
+
+      _entities[i] = entity;
+      _angular[i] = obb != nullptr;
+      for (i32 axis = 0; axis < 3; ++axis) {
+        _position[axis][i] = transform.GetPosition()[axis];
+        _velocity[axis][i] = body.velocity[axis];
+        _acceleration[axis][i] = acceleration[axis];
+        _angular_velocity[axis][i] = body.angular_velocity[axis];
+        _angular_acceleration[axis][i] = angular_acceleration[axis];
+      }
+      i++;
+    });
+
+    // Padding lanes past the awake bodies are still zeroed from Resize
+    _count = i;
+    _entities.resize(i);
+    _angular.resize(i);
+  }
+
+  void PhysicsWorld::IntegrateVelocities(entt::registry &registry, f64 step) {
+    u32 padded = SIMDPadded(_count);
+    for (i32 axis = 0; axis < 3; ++axis) {
+      IntegrateVelocityLanes(_velocity[axis].data(), _acceleration[axis].data(), padded, (f32)step);
+      IntegrateVelocityLanes(_angular_velocity[axis].data(), _angular_acceleration[axis].data(), padded, (f32)step);
+    }
+
+    for (u32 i = 0; i < _count; ++i) {
+      RigidBody &body = registry.get<RigidBody>(_entities[i]);
+      body.velocity = v3(_velocity[0][i], _velocity[1][i], _velocity[2][i]);
+      // Only boxes rotate
+      if (_angular[i])
+        body.angular_velocity = v3(_angular_velocity[0][i], _angular_velocity[1][i], _angular_velocity[2][i]);
+    }
+  }
+
+  void PhysicsWorld::IntegratePositions(entt::registry &registry, f64 step) {
+    for (u32 i = 0; i < _count; ++i) {
+      const RigidBody &body = registry.get<RigidBody>(_entities[i]);
+      for (i32 axis = 0; axis < 3; ++axis)
+        _velocity[axis][i] = body.velocity[axis];
+    }
+
+    u32 padded = SIMDPadded(_count);
+    for (i32 axis = 0; axis < 3; ++axis)
+      IntegratePositionLanes(_position[axis].data(), _velocity[axis].data(), padded, (f32)step);
+
+    for (u32 i = 0; i < _count; ++i) {
+      Transform &transform = registry.get<Transform>(_entities[i]);
+      const RigidBody &body = registry.get<RigidBody>(_entities[i]);
+      // Leave resting bodies alone so their transforms do not get dirty
+      if (epsilonNotEqual(length2(body.velocity), 0.0f, std::numeric_limits<f32>::epsilon()))
+        transform.SetPosition(v3(_position[0][i], _position[1][i], _position[2][i]));
+      if (_angular[i] && epsilonNotEqual(length2(body.angular_velocity), 0.0f, std::numeric_limits<f32>::epsilon()))
+        transform.SetRotationEuler(transform.GetRotationEuler() + degrees(body.angular_velocity) * (f32)step);
+    }
+  }
+
+} // namespace axl
@@ -4,13 +4,36 @@
 
 layout(location = UNIFORM_TEXTURES) uniform sampler2D textures[TEXTURE_COUNT];
 
-layout(std140) uniform Lights {
-  int count;
+layout(std140, binding = UNIFORM_BLOCK_CAMERA) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 view_projection;
+}
+camera;
+
+layout(std140, binding = UNIFORM_BLOCK_LIGHTS) uniform Lights {
+  ivec4 cluster_grid; // xyz = clusters per axis, w = point light count
   vec4 camera_position;
-  Light data[LIGHT_COUNT];
+  vec4 cluster_depth; // x = near, y = far, z = scale, w = bias
+  vec4 viewport;
+  Light ambient;
+  Light directional;
 }
 lights;
 
+layout(std430, binding = STORAGE_POINT_LIGHTS) readonly buffer PointLights {
+  Light point_lights[];
+};
+
+// Offset and count into cluster_lights for every cluster
+layout(std430, binding = STORAGE_CLUSTERS) readonly buffer Clusters {
+  uvec2 clusters[];
+};
+
+layout(std430, binding = STORAGE_CLUSTER_LIGHTS) readonly buffer ClusterLights {
+  uint cluster_lights[];
+};
+
 layout(location = 0) in Vertex {
   vec3 position;
   vec2 tex_coord;
@@ -20,8 +43,16 @@ IN;
 
 layout(location = 0) out vec4 frag_color;
 
+uint ClusterIndex(vec3 position) {
+  ivec3 grid = lights.cluster_grid.xyz;
+  float depth = max(-(camera.view * vec4(position, 1.0)).z, lights.cluster_depth.x);
+  int slice = clamp(int(floor(log(depth) * lights.cluster_depth.z + lights.cluster_depth.w)), 0, grid.z - 1);
+  ivec2 tile = clamp(ivec2(gl_FragCoord.xy / lights.viewport.xy * vec2(grid.xy)), ivec2(0), grid.xy - 1);
+  return uint(tile.x + grid.x * (tile.y + grid.y * slice));
+}
+
 void main() {
-  vec4 ambient_light_color = lights.data[0].color * lights.data[0].intensity;
+  vec4 ambient_light_color = lights.ambient.color * lights.ambient.intensity;
 
   vec3 normal = texture(textures[TEXTURE_NORMAL], IN.tex_coord).rgb;
   normal = normal * 2.0 - 1.0;
@@ -33,7 +64,7 @@ void main() {
   vec4 diffuse_light_color = vec4(0.0);
   vec4 specular_light_color = vec4(0.0);
 
-  Light directional_light = lights.data[1];
+  Light directional_light = lights.directional;
   vec3 light_direction = normalize(directional_light.position.xyz);
   float light_distance = length(position - light_direction);
   float light_intensity = max(0.0, dot(normal, light_direction)) * directional_light.intensity;
@@ -42,16 +73,24 @@ void main() {
     directional_light.color *
     pow(max(0.0, dot(normalize(view_position - position), reflect(-light_direction, normal))), 32.0);
 
-  for (int i = 2; i < lights.count; i++) {
-    Light light = lights.data[i];
-    vec3 light_direction = normalize(light.position.xyz - position);
+  // Only the point lights binned into the cluster of this fragment
+  uvec2 cluster = clusters[ClusterIndex(position)];
+  for (uint i = 0; i < cluster.y; i++) {
+    Light light = point_lights[cluster_lights[cluster.x + i]];
+    vec3 light_offset = light.position.xyz - position;
+    float light_distance = length(light_offset);
+    // Smooth window reaching zero at the range, so nothing is lost outside the clusters a light was binned into
+    float falloff = clamp(1.0 - pow(light_distance / light.range, 2.0), 0.0, 1.0);
+    falloff *= falloff;
+
+    vec3 light_direction = light_offset / max(light_distance, 0.0001);
     float light_intensity = max(dot(normal, light_direction), 0.0);
-    light_intensity = clamp(light_intensity, 0.0, 1.0) * light.intensity;
+    light_intensity = clamp(light_intensity, 0.0, 1.0) * light.intensity * falloff;
     diffuse_light_color += light.color * light_intensity;
 
     vec3 half_direction = normalize(light_direction + view_position);
     float specular_intensity = pow(clamp(dot(normal, half_direction), 0.0, 1.0), 32.0);
-    specular_light_color += light.color * specular_intensity;
+    specular_light_color += light.color * specular_intensity * falloff;
   }
 
   vec4 ambient_color = texture(textures[TEXTURE_DIFFUSE], IN.tex_coord) * ambient_light_color;
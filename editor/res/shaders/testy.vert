@@ -7,9 +7,22 @@ layout(location = ATTRIB_NORMAL) in vec3 normal;
 layout(location = ATTRIB_TANGENT) in vec3 tangent;
 layout(location = ATTRIB_TEXCOORD) in vec2 tex_coord;
 
-layout(location = UNIFORM_MODEL_MATRIX) uniform mat4 model;
-layout(location = UNIFORM_VIEW_MATRIX) uniform mat4 view;
-layout(location = UNIFORM_PROJECTION_MATRIX) uniform mat4 projection;
+layout(std140, binding = UNIFORM_BLOCK_CAMERA) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 view_projection;
+}
+camera;
+
+struct Object {
+  mat4 model;
+  mat4 normal_matrix;
+};
+
+// One entry per instance of the frame, draws start at their base instance
+layout(std430, binding = STORAGE_OBJECTS) readonly buffer Objects {
+  Object objects[];
+};
 
 layout(location = 0) out Vertex {
   vec3 position;
@@ -19,13 +32,14 @@ layout(location = 0) out Vertex {
 OUT;
 
 void main() {
-  mat4 mvp = projection * view * model;
-  gl_Position = mvp * vec4(position, 1.0);
+  Object object = objects[gl_BaseInstance + gl_InstanceID];
+  vec4 world_position = object.model * vec4(position, 1.0);
+  gl_Position = camera.view_projection * world_position;
 
-  OUT.position = vec3(model * vec4(position, 1.0));
+  OUT.position = vec3(world_position);
   OUT.tex_coord = tex_coord;
 
-  mat3 transpose_inverse_model = transpose(inverse(mat3(model)));
+  mat3 transpose_inverse_model = mat3(object.normal_matrix);
   vec3 transformed_normal = transpose_inverse_model * normal;
 
   vec3 tangent = transpose_inverse_model * normalize(tangent);
@@ -22,6 +22,7 @@ struct Light {
   vec4 position;
   vec4 color;
   float intensity;
+  float range;
 };
 
 // Texture indices
@@ -49,9 +50,17 @@ struct Light {
 #define UNIFORM_CUSTOM_FRAGMENT 50
 
 // Vertex attribute locations
-#define ATTRIB_POSITION 0
-#define ATTRIB_NORMAL   1
-#define ATTRIB_TANGENT  2
-#define ATTRIB_TEXCOORD 3
+#define ATTRIB_POSITION       0
+#define ATTRIB_NORMAL         1
+#define ATTRIB_TANGENT        2
+#define ATTRIB_TEXCOORD       3
 
-#define LIGHT_COUNT 32
+// Uniform block bindings
+#define UNIFORM_BLOCK_LIGHTS 0
+#define UNIFORM_BLOCK_CAMERA 1
+
+// Storage buffer bindings
+#define STORAGE_POINT_LIGHTS   0
+#define STORAGE_CLUSTERS       1
+#define STORAGE_CLUSTER_LIGHTS 2
+#define STORAGE_OBJECTS        3
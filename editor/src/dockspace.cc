@@ -28,7 +28,21 @@ namespace axl {
         log::error("Project path does not exist");
         return;
       }
-      if (!std::filesystem::exists(data.project_path / "project.json")) {
+      std::filesystem::path binary_path = data.project_path / "project.axlscene";
+      std::filesystem::path json_path = data.project_path / "project.json";
+      bool has_json = std::filesystem::exists(json_path);
+
+      // Prefer the binary scene, unless project.json was edited after it was written
+      if (std::filesystem::exists(binary_path) &&
+          (!has_json || std::filesystem::last_write_time(binary_path) >= std::filesystem::last_write_time(json_path))) {
+        if (data.scene->DeserializeBinary(binary_path)) {
+          NFD_Free(out_path);
+          return;
+        }
+        log::warn("Falling back to `project.json`");
+      }
+
+      if (!has_json) {
         log::error("Project path does not contain `project.json`");
         return;
       }
@@ -59,6 +73,12 @@ namespace axl {
     json j = data.scene->Serialize();
     file << j.dump(4) << std::endl;
     file.close();
+
+    // Written after the json, so its timestamp marks it as the one to load
+    std::vector<u8> binary = data.scene->SerializeBinary();
+    std::ofstream binary_file(data.project_path / "project.axlscene", std::ios::binary);
+    binary_file.write((const char *)binary.data(), binary.size());
+    binary_file.close();
   }
 
   bool DockSpace::SelectProjectPath() {
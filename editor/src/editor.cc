@@ -3,8 +3,10 @@
 #include "ui.hh"
 
 #include <ImGuizmo.h>
+#include <axolotl/arena.hh>
 #include <axolotl/axolotl.hh>
 #include <axolotl/camera.hh>
+#include <axolotl/gputimer.hh>
 #include <axolotl/gui.hh>
 #include <axolotl/line.hh>
 #include <axolotl/physics.hh>
@@ -294,18 +296,32 @@ void MainLoop(Window &window, TerminalData &terminal_data) {
       ImGui::Text("FPS: %u", performance.fps);
       ImGui::Text("Delta: %.2fms", performance.delta_time * 1000.0);
       ImGui::Text("Meshes: %u", performance.mesh_count);
+      ImGui::Text("Culling: %u culled, %u submitted", performance.culled_count, performance.submitted_count);
       ImGui::Text("Physics Total: %.2fms", physics_time_total * 1000.0);
       ImGui::Text("Physics Update: %.2fms", physics_time * 1000.0);
       ImGui::Text("Physics Debug: %.2fms", physics_time_debug * 1000.0);
       ImGui::Text("Physics Update Count: %.2f per frame", physics_update_count);
+      ImGui::Text("Physics Proxies: %u", Physics::broadphase_proxy_count);
+      ImGui::Text("Physics Pairs: %u", Physics::broadphase_pair_count);
+      ImGui::Text("Physics Contacts: %u", Physics::contact_count);
+      ImGui::Text("Solver Iterations: %u", Physics::solver_iteration_count);
+      ImGui::Text("Sleeping Bodies: %u", Physics::sleeping_body_count);
+      ImGui::Text("Continuous Hits: %u", Physics::continuous_hit_count);
       ImGui::Text("Vertices: %u", performance.vertex_count);
       ImGui::Text("Triangles: %u", performance.triangle_count);
       ImGui::Text("Draw Calls: %u", performance.draw_calls);
+      ImGui::Text("Instances: %u", performance.instance_count);
+      ImGui::Text("Frame Arena: %.1fKB, %u mallocs",
+                  Arena::GetFrameArena().GetUsed() / 1024.0,
+                  Arena::GetFrameArena().GetSystemAllocations());
+      ImGui::Text("GL State Calls: %u issued, %u elided", performance.gl_calls_issued, performance.gl_calls_elided);
       ImGui::Text("ImGui Time: %.2fms", imgui_time * 1000.0);
       ImGui::Text("Update Time: %.2fms", update_time * 1000.0);
       ImGui::Text("Main Draw Time: %.2fms", performance.main_draw_time * 1000.0);
       ImGui::Text("Post Draw Time: %.2fms", performance.post_draw_time * 1000.0);
       ImGui::Text("GPU Render Time: %.2fms", performance.gpu_render_time);
+      for (const GPUTimer::Scope &scope : renderer.GetGPUTimer().GetScopes())
+        ImGui::Text("  GPU %s: %.2fms", scope.name.c_str(), scope.time);
       ImGui::Text("CPU Render Time: %.2fms", performance.cpu_render_time * 1000.0);
       ImGui::Text("Organization Time: %.2fms", performance.organization_time * 1000.0);
       ImGui::Text("Light Update Time: %.2fms", performance.lights_time * 1000.0);
@@ -361,4 +377,5 @@ i32 main() {
   TerminalData terminal_data;
 
   MainLoop(window, terminal_data);
+  Axolotl::Terminate();
 }
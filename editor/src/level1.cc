@@ -70,6 +70,9 @@ namespace axl {
     _platform_id = *uuid::from_string("ed2f5ded-2c14-456f-b426-43c5a45121cd");
     _elevator_id = *uuid::from_string("e5095876-2cb9-4ecd-abda-33d0ebd87143");
 
+    // Jumps are fast enough to skip through the thin platforms at the fixed step
+    FromID(_player_id).GetComponent<RigidBody>().continuous = true;
+
     window.GetRenderer().SetAmbientLight(Light(LightType::Ambient, v3(0.6f), 0.4f));
     window.GetRenderer().SetDirectionalLight(Light(LightType::Directional, v3(1.0f), 0.4f));
   }
@@ -111,19 +114,16 @@ namespace axl {
     SphereCollider &sc = player_ento.GetComponent<SphereCollider>();
     Ray ray(start_ray, { 0.0f, -1.0f, 0.0f });
 
-    _registry.view<OBBCollider>().each([&](auto entity, OBBCollider &obb) {
-      f32 dist = obb.RayInside(ray);
-      if (dist > 0.0f) {
-        no_landing = false;
+    RaycastHit ground = Physics::Raycast(*this, ray, RaycastMode::Closest, PHYSICS_LAYER_ALL, player_ento);
+    if (ground) {
+      no_landing = false;
 
-        v3 closest = obb.ClosestPoint(sc.position);
-        if (length2(closest - sc.position) <= sc.radius) {
+      if (const OBBCollider *obb = _registry.try_get<OBBCollider>(ground.entity)) {
+        v3 closest = obb->ClosestPoint(sc.position);
+        if (length2(closest - sc.position) <= sc.radius)
           grounded = true;
-        } else {
-        }
-        return;
       }
-    });
+    }
 
     if (no_landing) {
       _time_not_grounded += delta;
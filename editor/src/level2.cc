@@ -376,7 +376,8 @@ namespace axl {
     _player_ento = CreateEntity();
     _player_ento.Tag().value = "Player";
     _player_ento.AddComponent<SphereCollider>(_player_ento.Transform().GetPosition(), 1.0);
-    _player_ento.AddComponent<RigidBody>(1.0);
+    RigidBody &player_rb = _player_ento.AddComponent<RigidBody>(1.0);
+    player_rb.continuous = true;
     Transform &player_transform = _player_ento.Transform();
     player_transform.SetPosition(v3(first_empty_pos.x * 2, 2, first_empty_pos.y * 2));
     player_transform.SetScale(v3(1.0f, 1.0f, 1.0f));
@@ -660,21 +661,20 @@ namespace axl {
     SphereCollider &sc = _player_ento.GetComponent<SphereCollider>();
     Ray ray(start_ray, { 0.0f, -1.0f, 0.0f });
 
-    _registry.view<OBBCollider>().each([&](auto entity, OBBCollider &obb) {
-      f32 dist = obb.RayInside(ray);
-      if (dist > 0.0f) {
-        no_landing = false;
+    RaycastHit ground = Physics::Raycast(*this, ray, RaycastMode::Closest, PHYSICS_LAYER_ALL, _player_ento);
+    if (ground) {
+      no_landing = false;
 
-        v3 closest = obb.ClosestPoint(sc.position);
+      if (const OBBCollider *obb = _registry.try_get<OBBCollider>(ground.entity)) {
+        v3 closest = obb->ClosestPoint(sc.position);
         if (length2(closest - sc.position) <= sc.radius) {
           grounded = true;
         } else {
           // LinePrimitive lp(start_ray, closest, Color(0.0f, 1.0f, 0));
           // window.GetRenderer().AddLine(lp);
         }
-        return;
       }
-    });
+    }
 
     constexpr f32 MOVEMENT_SPEED = 6.0f;
     constexpr f32 ROTATION_SPEED = 2.0f;
@@ -809,47 +809,29 @@ namespace axl {
       v3(0.15f, 0.0f, 0.15f), v3(-0.15f, 0.0f, 0.15f), v3(0.15f, 0.0f, -0.15f), v3(-0.15f, 0.0f, -0.15f),
     };
 
+    std::array<Ray, check_axis.size()> look_rays;
+    std::array<RaycastHit, check_axis.size()> look_hits;
+    for (i32 i = 0; i < (i32)check_axis.size(); ++i)
+      look_rays[i] = Ray(_enemy_ento.Transform().GetPosition(), check_axis[i]);
+    Physics::RaycastBatch(
+      *this, look_rays.data(), look_rays.size(), look_hits.data(), RaycastMode::Closest, PHYSICS_LAYER_ALL, _enemy_ento);
+
     _player_in_range = false;
     for (i32 i = 0; i < (i32)check_axis.size(); ++i) {
       const v3 &axis = check_axis[i];
-      Ray ray(_enemy_ento.Transform().GetPosition(), axis);
-      Ento min_dist_ento;
-      f32 min_dist = std::numeric_limits<f32>::max();
-
-      _registry.each([&](entt::entity e) {
-        Ento other_ento = FromHandle(e);
-        if (_enemy_ento == other_ento)
-          return;
-        if (other_ento.HasComponent<RigidBody>())
-          RigidBody &other_rb = other_ento.GetComponent<RigidBody>();
-
-        if (other_ento.HasComponent<SphereCollider>()) {
-          SphereCollider &other_collider = other_ento.GetComponent<SphereCollider>();
-          f32 dist = ray.SphereInside(other_collider);
-          if (dist > 0.0f && dist < min_dist) {
-            min_dist = dist;
-            min_dist_ento = other_ento;
-          }
-        } else if (other_ento.HasComponent<OBBCollider>()) {
-          OBBCollider &other_collider = other_ento.GetComponent<OBBCollider>();
-          f32 dist = ray.OBBInside(other_collider);
-          if (dist > 0.0f && dist < min_dist) {
-            min_dist = dist;
-            min_dist_ento = other_ento;
-
-            if (other_ento.Tag().value == "Coin") {
-              v2 coin_pos =
-                ToMazeCoord({ other_ento.Transform().GetPosition().x, other_ento.Transform().GetPosition().z });
-              if (std::find(_known_coins.begin(), _known_coins.end(), coin_pos) == _known_coins.end())
-                _known_coins.push_back(coin_pos);
-            }
-          }
-        }
-      });
-
-      if (!min_dist_ento)
+      if (!look_hits[i])
         continue;
 
+      Ento min_dist_ento = FromHandle(look_hits[i].entity);
+      f32 min_dist = look_hits[i].distance;
+
+      if (min_dist_ento.Tag().value == "Coin") {
+        v2 coin_pos =
+          ToMazeCoord({ min_dist_ento.Transform().GetPosition().x, min_dist_ento.Transform().GetPosition().z });
+        if (std::find(_known_coins.begin(), _known_coins.end(), coin_pos) == _known_coins.end())
+          _known_coins.push_back(coin_pos);
+      }
+
       if (min_dist_ento.Tag().value == "Player") {
         _last_known_player_position = min_dist_ento.Transform().GetPosition();
         _player_in_range = true;
@@ -0,0 +1,96 @@
+#include <axolotl/contact.hh>
+#include <axolotl/geometry.hh>
+#include <axolotl/physics.hh>
+
+using namespace axl;
+
+static i32 failures = 0;
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  log::error("{}", message);
+  failures++;
+}
+
+static CollisionManifold Manifold(std::initializer_list<v3> points) {
+  CollisionManifold manifold(v3(0.0f, 1.0f, 0.0f), 0.01f);
+  manifold.colliding = true;
+  for (const v3 &point : points)
+    manifold.points.push_back(point);
+  return manifold;
+}
+
+// Stands in for the solver, every point leaves the step with impulses that are easy to tell apart
+static void Solve(ContactConstraint &contact) {
+  for (u32 i = 0; i < contact.points.size(); ++i) {
+    contact.points[i].normal_impulse = 10.0 + i;
+    contact.points[i].tangent_impulse[0] = 20.0 + i;
+    contact.points[i].tangent_impulse[1] = 30.0 + i;
+  }
+}
+
+static void CheckPoint(const ContactConstraint &contact, u32 index, f64 inherited_from, const char *test) {
+  const ContactPoint &point = contact.points[index];
+  if (inherited_from < 0.0) {
+    Check(point.normal_impulse == 0.0 && point.tangent_impulse[0] == 0.0 && point.tangent_impulse[1] == 0.0,
+          fmt::format("{}: new point {} kept stale impulses", test, index));
+    return;
+  }
+  Check(point.normal_impulse == 10.0 + inherited_from && point.tangent_impulse[0] == 20.0 + inherited_from &&
+          point.tangent_impulse[1] == 30.0 + inherited_from,
+        fmt::format("{}: point {} did not inherit the impulses of old point {}", test, index, inherited_from));
+}
+
+static void TestPointSetChanges() {
+  RigidBody a(1.0);
+  RigidBody b(1.0);
+  v3 position_a(0.0f, -0.5f, 0.0f);
+  v3 position_b(0.0f, 0.5f, 0.0f);
+
+  ContactConstraint contact;
+  CollisionManifold square =
+    Manifold({ v3(-0.5f, 0.0f, -0.5f), v3(0.5f, 0.0f, -0.5f), v3(0.5f, 0.0f, 0.5f), v3(-0.5f, 0.0f, 0.5f) });
+  contact.Prepare(square, a, b, position_a, position_b);
+  for (u32 i = 0; i < 4; ++i)
+    CheckPoint(contact, i, -1.0, "first step");
+  Solve(contact);
+
+  // Same count, the first two slide past the match distance, the last two shuffle and barely move
+  CollisionManifold moved =
+    Manifold({ v3(-0.3f, 0.0f, -0.5f), v3(0.5f, 0.0f, -0.3f), v3(-0.5f, 0.0f, 0.51f), v3(0.5f, 0.0f, 0.5f) });
+  contact.Prepare(moved, a, b, position_a, position_b);
+  CheckPoint(contact, 0, -1.0, "moved points");
+  CheckPoint(contact, 1, -1.0, "moved points");
+  CheckPoint(contact, 2, 3.0, "moved points");
+  CheckPoint(contact, 3, 2.0, "moved points");
+  Solve(contact);
+
+  // Fewer points, the only survivor now sits in another slot
+  contact.Prepare(Manifold({ v3(0.0f, 0.0f, 0.0f), v3(0.5f, 0.0f, 0.5f) }), a, b, position_a, position_b);
+  Check(contact.points.size() == 2, "fewer points: constraint did not shrink");
+  CheckPoint(contact, 0, -1.0, "fewer points");
+  CheckPoint(contact, 1, 3.0, "fewer points");
+  Solve(contact);
+
+  // More points again, the slots that come back must not bring their old impulses with them
+  CollisionManifold spread =
+    Manifold({ v3(0.0f, 0.0f, 0.0f), v3(1.0f, 0.0f, 0.0f), v3(0.0f, 0.0f, 1.0f), v3(-1.0f, 0.0f, 0.0f) });
+  contact.Prepare(spread, a, b, position_a, position_b);
+  Check(contact.points.size() == 4, "more points: constraint did not grow");
+  CheckPoint(contact, 0, 0.0, "more points");
+  CheckPoint(contact, 1, -1.0, "more points");
+  CheckPoint(contact, 2, -1.0, "more points");
+  CheckPoint(contact, 3, -1.0, "more points");
+}
+
+i32 main() {
+  TestPointSetChanges();
+
+  if (failures) {
+    log::error("Contact test failed with {} errors", failures);
+    return 1;
+  }
+  log::info("Contact test passed");
+  return 0;
+}
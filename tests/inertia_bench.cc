@@ -0,0 +1,147 @@
+#include <axolotl/geometry.hh>
+#include <axolotl/physics.hh>
+#include <chrono>
+#include <random>
+
+using namespace axl;
+
+// Solver shaped load: every body is part of a contact that reads its tensor twice per impulse iteration
+constexpr u32 BODY_COUNT = 1024;
+constexpr u32 STEP_COUNT = 60;
+constexpr u32 ITERATION_COUNT = 10;
+constexpr f32 TENSOR_TOLERANCE = 1e-4f;
+
+static i32 failures = 0;
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  if (failures < 32)
+    log::error("{}", message);
+  failures++;
+}
+
+template<typename Function>
+static f64 Time(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// What RigidBody::InvTensor did before the tensor was cached, a collider lookup and a 4x4 inversion per call
+static m4 RecomputedInvTensor(const entt::registry &registry, entt::entity entity, f64 mass) {
+  if (mass == 0.0)
+    return m4(0.0f);
+
+  f64 ix = 0.0;
+  f64 iy = 0.0;
+  f64 iz = 0.0;
+  f64 iw = 0.0;
+
+  if (const SphereCollider *sphere = registry.try_get<SphereCollider>(entity)) {
+    f64 r2 = sphere->radius * sphere->radius;
+    constexpr f64 fraction = (2.0 / 5.0);
+
+    ix = r2 * mass * fraction;
+    iy = r2 * mass * fraction;
+    iz = r2 * mass * fraction;
+    iw = 1.0;
+  } else if (const OBBCollider *obb = registry.try_get<OBBCollider>(entity)) {
+    v3 size = obb->size * 2.0f;
+    constexpr f64 fraction = (1.0 / 12.0);
+    f64 x2 = size.x * size.x;
+    f64 y2 = size.y * size.y;
+    f64 z2 = size.z * size.z;
+
+    ix = (y2 + z2) * mass * fraction;
+    iy = (x2 + z2) * mass * fraction;
+    iz = (x2 + y2) * mass * fraction;
+    iw = 1.0;
+  }
+
+  return inverse(m4((f32)ix, 0, 0, 0, 0, (f32)iy, 0, 0, 0, 0, (f32)iz, 0, 0, 0, 0, (f32)iw));
+}
+
+static void UpdateInertia(entt::registry &registry) {
+  registry.view<RigidBody>().each([&](entt::entity entity, RigidBody &body) {
+    body.UpdateInertia(registry.try_get<SphereCollider>(entity), registry.try_get<OBBCollider>(entity));
+  });
+}
+
+i32 main() {
+  std::mt19937 random_generator(1234);
+  std::uniform_real_distribution<f32> unit(0.1f, 2.0f);
+
+  entt::registry registry;
+  std::vector<entt::entity> bodies(BODY_COUNT);
+  std::vector<v3> torques(BODY_COUNT);
+  for (u32 i = 0; i < BODY_COUNT; ++i) {
+    bodies[i] = registry.create();
+    registry.emplace<RigidBody>(bodies[i], unit(random_generator) * 10.0);
+    if (i % 2)
+      registry.emplace<SphereCollider>(bodies[i], v3(0.0f), unit(random_generator));
+    else
+      registry.emplace<OBBCollider>(bodies[i],
+                                    v3(0.0f),
+                                    v3(unit(random_generator), unit(random_generator), unit(random_generator)),
+                                    angleAxis(unit(random_generator), v3(0.0f, 1.0f, 0.0f)));
+    torques[i] = v3(unit(random_generator), unit(random_generator), unit(random_generator));
+  }
+
+  // The cached tensor is the old local one turned along the box axes
+  UpdateInertia(registry);
+  for (u32 i = 0; i < BODY_COUNT; ++i) {
+    const RigidBody &body = registry.get<RigidBody>(bodies[i]);
+    m3 expected = m3(RecomputedInvTensor(registry, bodies[i], body.mass));
+    if (const OBBCollider *obb = registry.try_get<OBBCollider>(bodies[i]))
+      expected = obb->GetRotationMatrix() * expected * transpose(obb->GetRotationMatrix());
+
+    for (i32 column = 0; column < 3; ++column)
+      for (i32 row = 0; row < 3; ++row) {
+        f32 a = body.InvTensor()[column][row];
+        f32 b = expected[column][row];
+        Check(std::abs(a - b) <= TENSOR_TOLERANCE * std::max(1.0f, std::abs(b)),
+              fmt::format("Body {} tensor [{}][{}] is {}, expected {}", i, column, row, a, b));
+      }
+  }
+
+  v3 recomputed_sum(0.0f);
+  f64 recomputed_time = Time([&]() {
+    for (u32 step = 0; step < STEP_COUNT; ++step)
+      for (u32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+        for (u32 i = 0; i < BODY_COUNT; ++i) {
+          f64 mass = registry.get<RigidBody>(bodies[i]).mass;
+          recomputed_sum += v3(v4(torques[i], 1.0f) * RecomputedInvTensor(registry, bodies[i], mass));
+          recomputed_sum += v3(v4(torques[i], 1.0f) * RecomputedInvTensor(registry, bodies[i], mass));
+        }
+  });
+
+  // The cached path pays for the refresh once per step, like PhysicsWorld::Gather does
+  v3 cached_sum(0.0f);
+  f64 cached_time = Time([&]() {
+    for (u32 step = 0; step < STEP_COUNT; ++step) {
+      UpdateInertia(registry);
+      for (u32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+        for (u32 i = 0; i < BODY_COUNT; ++i) {
+          const m3 &tensor = registry.get<RigidBody>(bodies[i]).InvTensor();
+          cached_sum += torques[i] * tensor;
+          cached_sum += torques[i] * tensor;
+        }
+    }
+  });
+
+  Check(!any(isnan(recomputed_sum)) && !any(isnan(cached_sum)), "Benchmark sums are not numbers");
+
+  u32 lookups = BODY_COUNT * STEP_COUNT * ITERATION_COUNT * 2;
+  log::info("Inverse inertia, {} lookups: recomputed {:.2f} ms, cached {:.2f} ms, {:.1f}x",
+            lookups,
+            recomputed_time,
+            cached_time,
+            recomputed_time / std::max(cached_time, 1e-6));
+
+  if (failures) {
+    log::error("Inertia benchmark failed with {} errors", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <axolotl/lookup.hh>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+
+using namespace axl;
+
+constexpr u32 ENTITY_COUNT = 100000;
+constexpr u32 CHURN_COUNT = 500000;
+
+static i32 failures = 0;
+static std::mt19937 random_generator(1234);
+static uuids::uuid_random_generator uuid_generator(random_generator);
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  if (failures < 32)
+    log::error("{}", message);
+  failures++;
+}
+
+template<typename Function>
+static f64 Time(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+class Entry {
+ public:
+  uuid id;
+  entt::entity handle;
+};
+
+// Same contents through both indices, std::unordered_map is the reference for every answer
+class Indices {
+ public:
+  entt::registry registry;
+  UUIDMap uuids;
+  HandleIndex handles;
+  std::unordered_map<uuid, entt::entity> reference;
+  std::vector<Entry> live;
+
+  void Insert() {
+    Entry entry { uuid_generator(), registry.create() };
+    uuids.Insert(entry.id, entry.handle);
+    handles.Insert(entry.handle, entry.id);
+    reference[entry.id] = entry.handle;
+    live.push_back(entry);
+  }
+
+  // Returns the erased entry, so stale lookups can be checked against it
+  Entry EraseRandom() {
+    u32 index = std::uniform_int_distribution<u32>(0, (u32)live.size() - 1)(random_generator);
+    Entry entry = live[index];
+    live[index] = live.back();
+    live.pop_back();
+
+    uuids.Erase(entry.id);
+    handles.Erase(entry.handle);
+    reference.erase(entry.id);
+    registry.destroy(entry.handle);
+    return entry;
+  }
+
+  void Verify(const char *phase) {
+    Check(uuids.Size() == reference.size(),
+          fmt::format("{}: UUIDMap holds {}, expected {}", phase, uuids.Size(), reference.size()));
+
+    for (const Entry &entry : live) {
+      Check(uuids.Find(entry.id) == entry.handle, fmt::format("{}: uuid lookup lost an entity", phase));
+      const uuid *id = handles.Find(entry.handle);
+      Check(id && *id == entry.id, fmt::format("{}: handle lookup lost an entity", phase));
+    }
+  }
+};
+
+static void TestChurn() {
+  Indices indices;
+  for (u32 i = 0; i < ENTITY_COUNT; ++i)
+    indices.Insert();
+  indices.Verify("insert");
+
+  // Erase heavy, most clusters get shifted back several times
+  for (u32 i = 0; i < ENTITY_COUNT * 9 / 10; ++i) {
+    Entry erased = indices.EraseRandom();
+    Check(indices.uuids.Find(erased.id) == entt::null, "erase: erased uuid is still found");
+    Check(indices.handles.Find(erased.handle) == nullptr, "erase: erased handle is still found");
+  }
+  indices.Verify("erase");
+
+  // Mixed churn around 100k live entities, recycled handles come back with a new version
+  std::uniform_int_distribution<u32> operation(0, 2);
+  for (u32 i = 0; i < CHURN_COUNT; ++i) {
+    u32 op = indices.live.size() < ENTITY_COUNT / 2 ? 0 : operation(random_generator);
+    if (op == 0 || (op == 1 && indices.live.size() < ENTITY_COUNT)) {
+      indices.Insert();
+      continue;
+    }
+
+    Entry erased = indices.EraseRandom();
+    Check(indices.uuids.Find(erased.id) == entt::null, "churn: erased uuid is still found");
+    Check(indices.handles.Find(erased.handle) == nullptr, "churn: stale handle is still found");
+  }
+  indices.Verify("churn");
+
+  for (u32 i = 0; i < 1000; ++i)
+    Check(indices.uuids.Find(uuid_generator()) == entt::null, "churn: unknown uuid was found");
+}
+
+static void Benchmark() {
+  std::vector<Entry> entries(ENTITY_COUNT);
+  entt::registry registry;
+  for (Entry &entry : entries)
+    entry = { uuid_generator(), registry.create() };
+
+  std::vector<Entry> shuffled = entries;
+  std::shuffle(shuffled.begin(), shuffled.end(), random_generator);
+
+  UUIDMap uuids;
+  HandleIndex handles;
+  std::unordered_map<uuid, entt::entity> uuid_reference;
+  std::unordered_map<entt::entity, uuid> handle_reference;
+
+  f64 insert_time = Time([&]() {
+    for (const Entry &entry : entries) {
+      uuids.Insert(entry.id, entry.handle);
+      handles.Insert(entry.handle, entry.id);
+    }
+  });
+  f64 insert_reference_time = Time([&]() {
+    for (const Entry &entry : entries) {
+      uuid_reference[entry.id] = entry.handle;
+      handle_reference[entry.handle] = entry.id;
+    }
+  });
+
+  u64 found = 0;
+  f64 find_time = Time([&]() {
+    for (const Entry &entry : shuffled)
+      found += (u64)uuids.Find(entry.id) + (u64)handles.Find(entry.handle)->is_nil();
+  });
+  u64 found_reference = 0;
+  f64 find_reference_time = Time([&]() {
+    for (const Entry &entry : shuffled)
+      found_reference += (u64)uuid_reference.find(entry.id)->second +
+                         (u64)handle_reference.find(entry.handle)->second.is_nil();
+  });
+  Check(found == found_reference, "Benchmark lookups disagree with std::unordered_map");
+
+  f64 erase_time = Time([&]() {
+    for (const Entry &entry : shuffled) {
+      uuids.Erase(entry.id);
+      handles.Erase(entry.handle);
+    }
+  });
+  f64 erase_reference_time = Time([&]() {
+    for (const Entry &entry : shuffled) {
+      uuid_reference.erase(entry.id);
+      handle_reference.erase(entry.handle);
+    }
+  });
+  Check(uuids.Size() == 0, "Benchmark left entries behind");
+
+  log::info("{} entities, lookup indices vs std::unordered_map", ENTITY_COUNT);
+  log::info("  insert {:.2f} ms vs {:.2f} ms", insert_time, insert_reference_time);
+  log::info("  find   {:.2f} ms vs {:.2f} ms", find_time, find_reference_time);
+  log::info("  erase  {:.2f} ms vs {:.2f} ms", erase_time, erase_reference_time);
+}
+
+i32 main() {
+  TestChurn();
+  Benchmark();
+
+  if (failures) {
+    log::error("Lookup test failed with {} errors", failures);
+    return 1;
+  }
+  return 0;
+}
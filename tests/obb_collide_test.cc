@@ -0,0 +1,175 @@
+#include <axolotl/geometry.hh>
+#include <chrono>
+#include <random>
+
+using namespace axl;
+
+constexpr f32 TOLERANCE = 1e-3f;
+constexpr u32 PAIR_COUNT = 4096;
+constexpr u32 REPEAT_COUNT = 64;
+
+static i32 failures = 0;
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  log::error("{}", message);
+  failures++;
+}
+
+template<typename Function>
+static f64 Time(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool Near(const v3 &a, const v3 &b) {
+  return length(a - b) <= TOLERANCE;
+}
+
+// Both orders of the pair must agree, with the normal pointing from the first box towards the second one
+static CollisionManifold Collide(const OBBCollider &a, const OBBCollider &b, const char *test) {
+  CollisionManifold manifold = a.OBBCollide(b);
+  CollisionManifold swapped = b.OBBCollide(a);
+  Check(manifold.colliding == swapped.colliding, fmt::format("{}: colliding depends on the order", test));
+  if (!manifold.colliding || !swapped.colliding)
+    return manifold;
+
+  Check(std::abs(length(manifold.normal) - 1.0f) <= TOLERANCE, fmt::format("{}: normal is not unit length", test));
+  Check(dot(manifold.normal, b.position - a.position) > 0.0f, fmt::format("{}: normal points from b to a", test));
+  Check(Near(manifold.normal, -swapped.normal), fmt::format("{}: swapped normal is not flipped", test));
+  Check(std::abs(manifold.depth - swapped.depth) <= TOLERANCE, fmt::format("{}: depth depends on the order", test));
+  Check(manifold.points.size() == swapped.points.size(), fmt::format("{}: point count depends on the order", test));
+  return manifold;
+}
+
+static void CheckPoints(const CollisionManifold &manifold, std::initializer_list<v3> expected, const char *test) {
+  Check(manifold.points.size() == expected.size(),
+        fmt::format("{}: {} points, expected {}", test, manifold.points.size(), expected.size()));
+  for (const v3 &point : expected) {
+    bool found = false;
+    for (const v3 &manifold_point : manifold.points)
+      found = found || Near(manifold_point, point);
+    Check(found, fmt::format("{}: missing point ({}, {}, {})", test, point.x, point.y, point.z));
+  }
+}
+
+static void TestFaceFace() {
+  // Small box resting inside the top face, the whole bottom face is in contact
+  OBBCollider ground(v3(0.0f), v3(1.0f));
+  OBBCollider box(v3(0.2f, 1.4f, 0.1f), v3(0.5f));
+  CollisionManifold manifold = Collide(ground, box, "face-face");
+  Check(manifold.colliding, "face-face: boxes are not colliding");
+  Check(Near(manifold.normal, v3(0.0f, 1.0f, 0.0f)), "face-face: normal is not +y");
+  Check(std::abs(manifold.depth - 0.1f) <= TOLERANCE, "face-face: depth is not 0.1");
+  // Points sit halfway between the incident face and the reference face
+  CheckPoints(manifold,
+              { v3(-0.3f, 0.95f, -0.4f), v3(0.7f, 0.95f, -0.4f), v3(0.7f, 0.95f, 0.6f), v3(-0.3f, 0.95f, 0.6f) },
+              "face-face");
+
+  // Hanging over a corner, the incident face gets clipped against two side planes of the reference face
+  OBBCollider overhang(v3(1.5f, 1.9f, 0.25f), v3(1.0f));
+  manifold = Collide(ground, overhang, "clipped face");
+  Check(manifold.colliding, "clipped face: boxes are not colliding");
+  Check(Near(manifold.normal, v3(0.0f, 1.0f, 0.0f)), "clipped face: normal is not +y");
+  Check(std::abs(manifold.depth - 0.1f) <= TOLERANCE, "clipped face: depth is not 0.1");
+  CheckPoints(manifold,
+              { v3(0.5f, 0.95f, -0.75f), v3(1.0f, 0.95f, -0.75f), v3(1.0f, 0.95f, 1.0f), v3(0.5f, 0.95f, 1.0f) },
+              "clipped face");
+
+  // Turned about the normal, the clipped polygon has eight corners and gets reduced
+  OBBCollider turned(v3(0.0f, 1.4f, 0.0f), v3(1.0f), angleAxis(radians(45.0f), v3(0.0f, 1.0f, 0.0f)));
+  manifold = Collide(ground, turned, "turned face");
+  Check(manifold.colliding, "turned face: boxes are not colliding");
+  Check(Near(manifold.normal, v3(0.0f, 1.0f, 0.0f)), "turned face: normal is not +y");
+  Check(manifold.points.size() == MANIFOLD_MAX_POINTS, "turned face: manifold was not reduced");
+  for (const v3 &point : manifold.points)
+    Check(std::abs(point.y - 0.95f) <= TOLERANCE && std::abs(point.x) <= 1.0f + TOLERANCE &&
+            std::abs(point.z) <= 1.0f + TOLERANCE,
+          "turned face: point is outside of the overlap");
+}
+
+static void TestEdgeEdge() {
+  // Two diamonds, the top edge of one runs along z and crosses the bottom edge of the other that runs along x
+  f32 corner = sqrt(2.0f);
+  OBBCollider a(v3(0.0f), v3(1.0f), angleAxis(radians(45.0f), v3(0.0f, 0.0f, 1.0f)));
+  OBBCollider b(v3(0.0f, 2.0f * corner - 0.1f, 0.0f), v3(1.0f), angleAxis(radians(45.0f), v3(1.0f, 0.0f, 0.0f)));
+  CollisionManifold manifold = Collide(a, b, "edge-edge");
+  Check(manifold.colliding, "edge-edge: boxes are not colliding");
+  Check(Near(manifold.normal, v3(0.0f, 1.0f, 0.0f)), "edge-edge: normal is not the cross product of the edges");
+  Check(std::abs(manifold.depth - 0.1f) <= TOLERANCE, "edge-edge: depth is not 0.1");
+  CheckPoints(manifold, { v3(0.0f, corner - 0.05f, 0.0f) }, "edge-edge");
+}
+
+static void TestSeparated() {
+  OBBCollider ground(v3(0.0f), v3(1.0f));
+  OBBCollider above(v3(0.0f, 2.1f, 0.0f), v3(1.0f));
+  Check(!Collide(ground, above, "separated face").colliding, "separated face: boxes are colliding");
+
+  OBBCollider turned(v3(2.5f, 0.0f, 0.0f), v3(1.0f), angleAxis(radians(30.0f), v3(0.0f, 1.0f, 0.0f)));
+  Check(!Collide(ground, turned, "separated turned").colliding, "separated turned: boxes are colliding");
+
+  // No face axis of either box separates these, only the cross product of the two edges does
+  f32 corner = sqrt(2.0f);
+  OBBCollider a(v3(0.0f), v3(1.0f), angleAxis(radians(45.0f), v3(0.0f, 0.0f, 1.0f)));
+  OBBCollider b(v3(0.0f, 2.0f * corner + 0.1f, 0.0f), v3(1.0f), angleAxis(radians(45.0f), v3(1.0f, 0.0f, 0.0f)));
+  Check(a.OBBInside(b) == a.OBBCollide(b).colliding, "separated edge: OBBCollide disagrees with OBBInside");
+  Check(!Collide(a, b, "separated edge").colliding, "separated edge: boxes are colliding");
+}
+
+static void Benchmark() {
+  std::mt19937 random_generator(1234);
+  std::uniform_real_distribution<f32> offset(-1.5f, 1.5f);
+  std::uniform_real_distribution<f32> extent(0.25f, 1.0f);
+  std::uniform_real_distribution<f32> angle(0.0f, 6.2831853f);
+
+  std::vector<OBBCollider> boxes(PAIR_COUNT * 2);
+  for (OBBCollider &box : boxes) {
+    v3 axis = normalize(v3(offset(random_generator), offset(random_generator), offset(random_generator)) + 0.01f);
+    box = OBBCollider(v3(offset(random_generator), offset(random_generator), offset(random_generator)),
+                      v3(extent(random_generator), extent(random_generator), extent(random_generator)),
+                      angleAxis(angle(random_generator), axis));
+  }
+
+  u32 colliding = 0;
+  u32 points = 0;
+  f64 collide_time = Time([&]() {
+    for (u32 repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+      for (u32 i = 0; i < PAIR_COUNT; ++i) {
+        CollisionManifold manifold = boxes[i * 2].OBBCollide(boxes[i * 2 + 1]);
+        colliding += manifold.colliding;
+        points += manifold.points.size();
+      }
+  });
+
+  u32 inside = 0;
+  f64 inside_time = Time([&]() {
+    for (u32 repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+      for (u32 i = 0; i < PAIR_COUNT; ++i)
+        inside += boxes[i * 2].OBBInside(boxes[i * 2 + 1]);
+  });
+
+  Check(colliding > 0 && inside > 0, "Benchmark: no pair is colliding");
+
+  u32 calls = PAIR_COUNT * REPEAT_COUNT;
+  log::info("OBBCollide, {} pairs: {:.2f} ms, {:.1f} ns per pair, {:.1f} points per contact",
+            calls,
+            collide_time,
+            collide_time * 1e6 / calls,
+            colliding ? (f64)points / colliding : 0.0);
+  log::info("OBBInside,  {} pairs: {:.2f} ms, {:.1f} ns per pair", calls, inside_time, inside_time * 1e6 / calls);
+}
+
+i32 main() {
+  TestFaceFace();
+  TestEdgeEdge();
+  TestSeparated();
+  Benchmark();
+
+  if (failures) {
+    log::error("OBBCollide test failed with {} errors", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,253 @@
+#include <axolotl/broadphase.hh>
+#include <axolotl/geometry.hh>
+#include <axolotl/packet.hh>
+#include <axolotl/simd.hh>
+#include <random>
+
+using namespace axl;
+
+// Built once per kernel path, every case is compared against the scalar functions in geometry.cc.
+// Cases that land within this distance of a decision boundary are skipped, the two sides round differently there.
+constexpr f64 BOUNDARY_MARGIN = 1e-3;
+constexpr u32 CASE_COUNT = 4096;
+
+static i32 failures = 0;
+static u32 skipped = 0;
+static std::mt19937 random_generator(1234);
+
+static f32 RandomRange(f32 min, f32 max) {
+  return std::uniform_real_distribution<f32>(min, max)(random_generator);
+}
+
+static u32 RandomCount(u32 max) {
+  return std::uniform_int_distribution<u32>(1, max)(random_generator);
+}
+
+static v3 RandomPoint(f32 extent) {
+  return v3(RandomRange(-extent, extent), RandomRange(-extent, extent), RandomRange(-extent, extent));
+}
+
+static v3 RandomDirection() {
+  v3 direction;
+  do {
+    direction = RandomPoint(1.0f);
+  } while (length2(direction) < 0.01f);
+  return normalize(direction);
+}
+
+static bool NearBoundary(f64 value, f64 boundary) {
+  return std::abs(value - boundary) < BOUNDARY_MARGIN;
+}
+
+static void Check(bool condition, const char *test, u32 test_case, u32 lane) {
+  if (condition)
+    return;
+  if (failures < 32)
+    log::error("{} case {} lane {} does not match the scalar result", test, test_case, lane);
+  failures++;
+}
+
+static void CheckDistance(f32 distance, f64 expected, const char *test, u32 test_case, u32 lane) {
+  Check(std::abs(distance - expected) <= BOUNDARY_MARGIN * std::max(1.0, std::abs(expected)), test, test_case, lane);
+}
+
+static void CheckUnusedLanes(u32 mask, u32 count, const char *test, u32 test_case) {
+  for (u32 lane = count; lane < 32; ++lane)
+    Check(!(mask & (1u << lane)), test, test_case, lane);
+}
+
+// Slab distances of the ray against the box, the inputs of every decision the slab tests make
+static void Slabs(const Ray &ray, const v3 &min, const v3 &max, f64 &t_near, f64 &t_far) {
+  t_near = -std::numeric_limits<f64>::max();
+  t_far = std::numeric_limits<f64>::max();
+  for (i32 axis = 0; axis < 3; ++axis) {
+    f64 t0 = ((f64)min[axis] - ray.position[axis]) / ray.GetDirection()[axis];
+    f64 t1 = ((f64)max[axis] - ray.position[axis]) / ray.GetDirection()[axis];
+    t_near = std::max(t_near, std::min(t0, t1));
+    t_far = std::min(t_far, std::max(t0, t1));
+  }
+}
+
+static bool AABBNearBoundary(const AABBCollider &a, const AABBCollider &b) {
+  for (i32 axis = 0; axis < 3; ++axis)
+    if (NearBoundary(a.GetMin()[axis], b.GetMax()[axis]) || NearBoundary(a.GetMax()[axis], b.GetMin()[axis]))
+      return true;
+  return false;
+}
+
+static void TestAABBInside() {
+  for (u32 test_case = 0; test_case < CASE_COUNT; ++test_case) {
+    AABBPacket packet;
+    AABBCollider boxes[GEOMETRY_PACKET_SIZE];
+    u32 count = RandomCount(GEOMETRY_PACKET_SIZE);
+    for (u32 i = 0; i < count; ++i) {
+      boxes[i] = AABBCollider(RandomPoint(5.0f), RandomPoint(2.0f));
+      packet.Set(i, boxes[i]);
+    }
+
+    AABBCollider query(RandomPoint(5.0f), RandomPoint(2.0f));
+    u32 mask = packet.AABBInside(query);
+    for (u32 i = 0; i < count; ++i) {
+      if (AABBNearBoundary(boxes[i], query)) {
+        skipped++;
+        continue;
+      }
+      Check((bool)(mask & (1u << i)) == boxes[i].AABBInside(query), "AABBPacket::AABBInside", test_case, i);
+    }
+    CheckUnusedLanes(mask, count, "AABBPacket::AABBInside", test_case);
+  }
+}
+
+static void TestAABBRayInside() {
+  for (u32 test_case = 0; test_case < CASE_COUNT; ++test_case) {
+    AABBPacket packet;
+    AABBCollider boxes[GEOMETRY_PACKET_SIZE];
+    u32 count = RandomCount(GEOMETRY_PACKET_SIZE);
+    for (u32 i = 0; i < count; ++i) {
+      boxes[i] = AABBCollider(RandomPoint(5.0f), RandomPoint(2.0f));
+      packet.Set(i, boxes[i]);
+    }
+
+    Ray ray(RandomPoint(8.0f), RandomDirection());
+    f32 distances[GEOMETRY_PACKET_SIZE];
+    u32 mask = packet.RayInside(ray, distances);
+    for (u32 i = 0; i < count; ++i) {
+      f64 t_near, t_far;
+      Slabs(ray, boxes[i].GetMin(), boxes[i].GetMax(), t_near, t_far);
+      if (NearBoundary(t_near, t_far) || NearBoundary(t_far, 0.0) || NearBoundary(t_near, 0.0)) {
+        skipped++;
+        continue;
+      }
+
+      f64 expected = ray.AABBInside(boxes[i]);
+      bool hit = mask & (1u << i);
+      Check(hit == (expected >= 0.0), "AABBPacket::RayInside", test_case, i);
+      CheckDistance(distances[i], hit ? expected : -1.0, "AABBPacket::RayInside distance", test_case, i);
+    }
+    CheckUnusedLanes(mask, count, "AABBPacket::RayInside", test_case);
+  }
+}
+
+static void TestSphereInside() {
+  for (u32 test_case = 0; test_case < CASE_COUNT; ++test_case) {
+    SpherePacket packet;
+    SphereCollider spheres[GEOMETRY_PACKET_SIZE];
+    u32 count = RandomCount(GEOMETRY_PACKET_SIZE);
+    for (u32 i = 0; i < count; ++i) {
+      spheres[i] = SphereCollider(RandomPoint(5.0f), RandomRange(0.1f, 2.0f));
+      packet.Set(i, spheres[i]);
+    }
+
+    SphereCollider query(RandomPoint(5.0f), RandomRange(0.1f, 2.0f));
+    u32 mask = packet.SphereInside(query);
+    for (u32 i = 0; i < count; ++i) {
+      if (NearBoundary(length(spheres[i].position - query.position), spheres[i].radius + query.radius)) {
+        skipped++;
+        continue;
+      }
+      Check((bool)(mask & (1u << i)) == spheres[i].SphereInside(query), "SpherePacket::SphereInside", test_case, i);
+    }
+    CheckUnusedLanes(mask, count, "SpherePacket::SphereInside", test_case);
+  }
+}
+
+static void TestSphereRayInside() {
+  for (u32 test_case = 0; test_case < CASE_COUNT; ++test_case) {
+    SpherePacket packet;
+    SphereCollider spheres[GEOMETRY_PACKET_SIZE];
+    u32 count = RandomCount(GEOMETRY_PACKET_SIZE);
+    for (u32 i = 0; i < count; ++i) {
+      spheres[i] = SphereCollider(RandomPoint(5.0f), RandomRange(0.1f, 3.0f));
+      packet.Set(i, spheres[i]);
+    }
+
+    Ray ray(RandomPoint(8.0f), RandomDirection());
+    f32 distances[GEOMETRY_PACKET_SIZE];
+    u32 mask = packet.RayInside(ray, distances);
+    for (u32 i = 0; i < count; ++i) {
+      v3 e = spheres[i].position - ray.position;
+      f64 r_sqr = spheres[i].radius * spheres[i].radius;
+      f64 e_sqr = length2(e);
+      f64 a = dot(e, ray.GetDirection());
+      f64 discriminant = r_sqr - (e_sqr - a * a);
+      f64 expected = ray.SphereInside(spheres[i]);
+      if (NearBoundary(discriminant, 0.0) || NearBoundary(e_sqr, r_sqr) || NearBoundary(expected, 0.0)) {
+        skipped++;
+        continue;
+      }
+
+      // The scalar test also returns negative distances for spheres behind the ray, neither counts as a hit
+      bool hit = mask & (1u << i);
+      Check(hit == (expected >= 0.0), "SpherePacket::RayInside", test_case, i);
+      CheckDistance(distances[i], hit ? expected : -1.0, "SpherePacket::RayInside distance", test_case, i);
+    }
+    CheckUnusedLanes(mask, count, "SpherePacket::RayInside", test_case);
+  }
+}
+
+static void TestBroadphaseRayMask() {
+  Broadphase broadphase;
+
+  for (u32 test_case = 0; test_case < CASE_COUNT; ++test_case) {
+    AABBCollider box(RandomPoint(5.0f), RandomPoint(3.0f));
+    BroadphaseNode node;
+    node.min = box.GetMin();
+    node.max = box.GetMax();
+
+    RayPacket packet;
+    Ray rays[BROADPHASE_RAY_PACKET_SIZE];
+    f32 max_distances[BROADPHASE_RAY_PACKET_SIZE];
+    packet.count = RandomCount(BROADPHASE_RAY_PACKET_SIZE);
+    for (u32 i = 0; i < packet.count; ++i) {
+      rays[i] = Ray(RandomPoint(10.0f), RandomDirection());
+      max_distances[i] = RandomRange(0.0f, 20.0f);
+      packet.Set(i, rays[i].position, rays[i].GetDirection(), max_distances[i]);
+    }
+
+    u32 active = random_generator();
+    u32 mask = broadphase.RayMask(packet, node, active);
+    for (u32 i = 0; i < packet.count; ++i) {
+      if (!(active & (1u << i))) {
+        Check(!(mask & (1u << i)), "Broadphase::RayMask inactive", test_case, i);
+        continue;
+      }
+
+      f64 t_near, t_far;
+      Slabs(rays[i], node.min, node.max, t_near, t_far);
+      if (NearBoundary(t_near, t_far) || NearBoundary(t_far, 0.0) || NearBoundary(t_near, 0.0) ||
+          NearBoundary(t_near, max_distances[i])) {
+        skipped++;
+        continue;
+      }
+
+      // The node is reached when the ray starts inside it or enters it before running out
+      f64 distance = rays[i].AABBInside(box);
+      bool expected = distance >= 0.0 && (box.PointInside(rays[i].position) || distance <= max_distances[i]);
+      Check((bool)(mask & (1u << i)) == expected, "Broadphase::RayMask", test_case, i);
+    }
+    CheckUnusedLanes(mask, packet.count, "Broadphase::RayMask", test_case);
+  }
+}
+
+i32 main() {
+#if defined(AXL_SIMD_AVX)
+  const char *path = "AVX";
+#elif defined(AXL_SIMD_SSE)
+  const char *path = "SSE";
+#else
+  const char *path = "scalar";
+#endif
+
+  TestAABBInside();
+  TestAABBRayInside();
+  TestSphereInside();
+  TestSphereRayInside();
+  TestBroadphaseRayMask();
+
+  if (failures) {
+    log::error("{} kernels: {} mismatches", path, failures);
+    return 1;
+  }
+  log::info("{} kernels match the scalar functions, {} boundary cases skipped", path, skipped);
+  return 0;
+}
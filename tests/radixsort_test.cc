@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <axolotl/arena.hh>
+#include <axolotl/radixsort.hh>
+#include <random>
+
+using namespace axl;
+
+constexpr u32 ENTRY_COUNT = 10000;
+
+static i32 failures = 0;
+static std::mt19937_64 random_generator(1234);
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  log::error("{}", message);
+  failures++;
+}
+
+// The index is the original position, equal keys must keep it ascending
+class Entry {
+ public:
+  u64 key;
+  u32 index;
+};
+
+static void CheckSort(const std::vector<u64> &keys, const char *test) {
+  {
+    FrameVector<Entry> entries;
+    FrameVector<Entry> scratch;
+    std::vector<Entry> expected;
+    for (u32 i = 0; i < keys.size(); ++i) {
+      entries.push_back({ keys[i], i });
+      expected.push_back({ keys[i], i });
+    }
+
+    RadixSort(entries, scratch);
+    std::stable_sort(expected.begin(), expected.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+    Check(entries.size() == expected.size(),
+          fmt::format("{}: {} entries, expected {}", test, entries.size(), expected.size()));
+    u32 mismatches = 0;
+    for (u32 i = 0; i < entries.size() && i < expected.size(); ++i)
+      if (entries[i].key != expected[i].key || entries[i].index != expected[i].index)
+        mismatches++;
+    Check(mismatches == 0, fmt::format("{}: {} entries differ from std::stable_sort", test, mismatches));
+  }
+  Arena::GetFrameArena().Reset();
+}
+
+static std::vector<u64> RandomKeys(u32 count, u64 mask, u64 fixed = 0) {
+  std::vector<u64> keys(count);
+  for (u64 &key : keys)
+    key = (random_generator() & mask) | fixed;
+  return keys;
+}
+
+i32 main() {
+  CheckSort({}, "empty");
+  CheckSort({ 7 }, "single");
+  CheckSort({ 2, 1 }, "pair");
+
+  CheckSort(RandomKeys(ENTRY_COUNT, ~0ull), "random");
+
+  // Few distinct keys, stability is what decides the order inside every run
+  std::vector<u64> pool = RandomKeys(8, ~0ull);
+  std::vector<u64> duplicates(ENTRY_COUNT);
+  for (u64 &key : duplicates)
+    key = pool[random_generator() % pool.size()];
+  CheckSort(duplicates, "duplicates");
+
+  // Render keys within a frame, the pass and program digits never change and their passes are skipped
+  CheckSort(RandomKeys(ENTRY_COUNT, 0x0000ffffffffffffull, 0x4003000000000000ull), "fixed high digits");
+  // A single pass runs, the sorted entries end up in what used to be the scratch buffer
+  CheckSort(RandomKeys(ENTRY_COUNT, 0x00000000000000ffull, 0x1234567890abcd00ull), "single pass");
+  // Varying digits separated by constant ones, an odd and an even number of skipped passes in between
+  CheckSort(RandomKeys(ENTRY_COUNT, 0xff0000ff00ff0000ull, 0x0012340012005678ull), "interleaved digits");
+  CheckSort(std::vector<u64>(ENTRY_COUNT, 0xdeadbeefcafef00dull), "all equal");
+
+  if (failures) {
+    log::error("RadixSort test failed with {} errors", failures);
+    return 1;
+  }
+  log::info("RadixSort matches std::stable_sort");
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include <axolotl/renderstate.hh>
+
+using namespace axl;
+
+// Records what reaches the mock driver, RenderState is expected to forward only real changes
+class MockCalls {
+ public:
+  u32 use_program = 0;
+  u32 bind_vertex_array = 0;
+  u32 active_texture = 0;
+  u32 bind_texture = 0;
+  u32 bind_buffer_base = 0;
+  u32 bind_buffer_range = 0;
+  u32 enable = 0;
+  u32 disable = 0;
+  u32 depth_func = 0;
+  u32 cull_face = 0;
+  u32 polygon_mode = 0;
+
+  u32 last_program = 0;
+  u32 last_unit = 0;
+  u32 last_texture = 0;
+  u32 last_buffer = 0;
+  u64 last_offset = 0;
+};
+
+static MockCalls calls;
+static i32 failures = 0;
+
+static void Check(bool condition, const char *message) {
+  if (condition)
+    return;
+  log::error("{}", message);
+  failures++;
+}
+
+static GLDispatch MockDispatch() {
+  GLDispatch dispatch;
+  dispatch.UseProgram = [](u32 program) {
+    calls.use_program++;
+    calls.last_program = program;
+  };
+  dispatch.BindVertexArray = [](u32 vao) { calls.bind_vertex_array++; };
+  dispatch.ActiveTexture = [](u32 unit) {
+    calls.active_texture++;
+    calls.last_unit = unit;
+  };
+  dispatch.BindTexture = [](u32 target, u32 texture) {
+    calls.bind_texture++;
+    calls.last_texture = texture;
+  };
+  dispatch.BindBufferBase = [](u32 target, u32 index, u32 buffer) {
+    calls.bind_buffer_base++;
+    calls.last_buffer = buffer;
+  };
+  dispatch.BindBufferRange = [](u32 target, u32 index, u32 buffer, u64 offset, u64 size) {
+    calls.bind_buffer_range++;
+    calls.last_buffer = buffer;
+    calls.last_offset = offset;
+  };
+  dispatch.Enable = [](u32 capability) { calls.enable++; };
+  dispatch.Disable = [](u32 capability) { calls.disable++; };
+  dispatch.DepthFunc = [](u32 func) { calls.depth_func++; };
+  dispatch.CullFace = [](u32 mode) { calls.cull_face++; };
+  dispatch.PolygonMode = [](u32 mode) { calls.polygon_mode++; };
+  return dispatch;
+}
+
+static void Reset() {
+  calls = MockCalls();
+  RenderState::SetDispatch(MockDispatch());
+  RenderState::ResetCounters();
+}
+
+static void TestProgramAndVertexArray() {
+  Reset();
+  RenderState::UseProgram(3);
+  RenderState::UseProgram(3);
+  RenderState::UseProgram(4);
+  Check(calls.use_program == 2 && calls.last_program == 4, "Repeated UseProgram reached the driver");
+
+  RenderState::BindVertexArray(7);
+  RenderState::BindVertexArray(7);
+  Check(calls.bind_vertex_array == 1, "Repeated BindVertexArray reached the driver");
+
+  Check(RenderState::GetIssuedCount() == 3 && RenderState::GetElidedCount() == 2, "Issued and elided counts are off");
+
+  // A deleted program name can be handed out again, binding it must not be skipped
+  RenderState::ForgetProgram(4);
+  RenderState::UseProgram(4);
+  Check(calls.use_program == 3, "Forgotten program was not bound again");
+}
+
+static void TestTextures() {
+  Reset();
+  RenderState::BindTexture(0, 1, 10);
+  RenderState::BindTexture(0, 1, 10);
+  Check(calls.bind_texture == 1 && calls.active_texture == 1, "Repeated BindTexture reached the driver");
+
+  // Another unit needs the active unit switched, the same unit again does not
+  RenderState::BindTexture(2, 1, 11);
+  RenderState::BindTexture(2, 1, 12);
+  Check(calls.active_texture == 2 && calls.last_unit == 2, "Active texture unit was not switched once");
+  Check(calls.bind_texture == 3 && calls.last_texture == 12, "Texture changes were not bound");
+  Check(RenderState::GetBoundTexture(0) == 10 && RenderState::GetBoundTexture(2) == 12, "Bound textures are off");
+
+  RenderState::ForgetTexture(10);
+  Check(RenderState::GetBoundTexture(0) == 0, "Forgotten texture is still reported as bound");
+  RenderState::BindTexture(0, 1, 10);
+  Check(calls.bind_texture == 4, "Forgotten texture was not bound again");
+}
+
+static void TestBuffers() {
+  Reset();
+  RenderState::BindUniformBuffer(1, 5);
+  RenderState::BindUniformBuffer(1, 5);
+  Check(calls.bind_buffer_base == 1, "Repeated BindUniformBuffer reached the driver");
+
+  // Ranges of the same buffer are different bindings
+  RenderState::BindUniformBufferRange(1, 5, 256, 128);
+  RenderState::BindUniformBufferRange(1, 5, 256, 128);
+  RenderState::BindUniformBufferRange(1, 5, 512, 128);
+  Check(calls.bind_buffer_range == 2 && calls.last_offset == 512, "Uniform buffer ranges were not tracked");
+
+  RenderState::BindUniformBuffer(1, 5);
+  Check(calls.bind_buffer_base == 2, "Whole buffer after a range was not bound again");
+
+  RenderState::BindStorageBuffer(0, 6);
+  RenderState::BindStorageBuffer(0, 6);
+  RenderState::BindStorageBuffer(1, 6);
+  Check(calls.bind_buffer_base == 4 && calls.last_buffer == 6, "Storage buffer bindings were not tracked per index");
+}
+
+static void TestFixedFunction() {
+  Reset();
+  RenderState::SetDepthTest(true);
+  RenderState::SetDepthTest(true);
+  RenderState::SetDepthTest(false);
+  Check(calls.enable == 1 && calls.disable == 1, "Depth test toggles were not elided");
+
+  RenderState::SetCullFace(true);
+  RenderState::SetCullFace(true);
+  Check(calls.enable == 2, "Repeated SetCullFace reached the driver");
+
+  RenderState::SetDepthFunc(1);
+  RenderState::SetDepthFunc(1);
+  RenderState::SetCullMode(2);
+  RenderState::SetCullMode(2);
+  RenderState::SetPolygonMode(3);
+  RenderState::SetPolygonMode(3);
+  Check(calls.depth_func == 1 && calls.cull_face == 1 && calls.polygon_mode == 1,
+        "Repeated fixed function state reached the driver");
+
+  // After an invalidate nothing cached can be trusted
+  RenderState::Invalidate();
+  RenderState::SetDepthTest(false);
+  RenderState::SetDepthFunc(1);
+  Check(calls.disable == 2 && calls.depth_func == 2, "Invalidate did not drop the cached state");
+}
+
+i32 main() {
+  TestProgramAndVertexArray();
+  TestTextures();
+  TestBuffers();
+  TestFixedFunction();
+
+  if (failures) {
+    log::error("RenderState failed with {} errors", failures);
+    return 1;
+  }
+  log::info("RenderState passed");
+  return 0;
+}
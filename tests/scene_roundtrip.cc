@@ -0,0 +1,161 @@
+#include <axolotl/axolotl.hh>
+#include <axolotl/ento.hh>
+#include <axolotl/geometry.hh>
+#include <axolotl/light.hh>
+#include <axolotl/physics.hh>
+#include <axolotl/scene.hh>
+#include <axolotl/transform.hh>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+using namespace axl;
+
+class RoundTripScene: public Scene {
+ public:
+  void Init(Window &window) override { }
+  void Update(Window &window, f64 delta) override { }
+  void Focused(Window &window, bool stat) override { }
+};
+
+// Component id and entity uuid => every member that has a json conversion, which is what both formats write
+using Snapshot = std::map<std::pair<entt::id_type, std::string>, json>;
+
+static i32 failures = 0;
+
+static void Check(bool condition, const std::string &message) {
+  if (condition)
+    return;
+  log::error("{}", message);
+  failures++;
+}
+
+static Snapshot TakeSnapshot(Scene &scene) {
+  using namespace entt::literals;
+
+  Snapshot snapshot;
+  entt::registry &registry = scene.GetRegistry();
+  for (auto [id, pool] : registry.storage()) {
+    auto meta = entt::resolve(id);
+    if (!meta)
+      continue;
+
+    entt::meta_func get = meta.func("get"_hs);
+    for (entt::entity entity : pool) {
+      auto handle = get.invoke({}, entt::forward_as_meta(registry), entity);
+
+      json members = json::object();
+      for (entt::meta_data data : meta.data()) {
+        auto member = data.get(handle);
+        member.allow_cast<json>();
+        json *value = member.try_cast<json>();
+        if (value)
+          members[data.prop("name"_hs).value().cast<std::string>()] = *value;
+      }
+
+      snapshot[{ id, uuids::to_string(scene.FromHandle(entity).id) }] = std::move(members);
+    }
+  }
+  return snapshot;
+}
+
+static void Compare(const Snapshot &expected, const Snapshot &loaded, const std::string &format) {
+  Check(expected.size() == loaded.size(),
+        fmt::format("{}: {} components saved, {} loaded", format, expected.size(), loaded.size()));
+
+  for (auto &[key, members] : expected) {
+    auto it = loaded.find(key);
+    if (it == loaded.end()) {
+      Check(false, fmt::format("{}: entity {} lost component {}", format, key.second, key.first));
+      continue;
+    }
+    Check(it->second == members,
+          fmt::format("{}: entity {} component {} differs\n  saved  {}\n  loaded {}",
+                      format,
+                      key.second,
+                      key.first,
+                      members.dump(),
+                      it->second.dump()));
+  }
+}
+
+static void CheckHierarchy(Scene &scene, uuid parent, uuid child, const std::string &format) {
+  Ento loaded_parent = scene.FromID(parent);
+  Ento loaded_child = scene.FromID(child);
+  Check(loaded_parent && loaded_child, fmt::format("{}: hierarchy entities missing", format));
+  if (!loaded_parent || !loaded_child)
+    return;
+
+  Check(loaded_child.HasParent() && loaded_child.Parent().id == parent,
+        fmt::format("{}: child lost its parent", format));
+  std::vector<Ento> children = loaded_parent.Children();
+  Check(children.size() == 1 && children[0].id == child, fmt::format("{}: parent lost its child", format));
+}
+
+static void Populate(Scene &scene, uuid &parent_id, uuid &child_id) {
+  Ento floor = scene.CreateEntity("Floor");
+  floor.Transform().SetPosition(v3(0.0f, -1.0f, 0.0f));
+  floor.Transform().SetScale(v3(20.0f, 1.0f, 20.0f));
+  floor.AddComponent<RigidBody>(0.0, 0.8, 0.1);
+  floor.AddComponent<OBBCollider>(v3(0.0f), v3(20.0f, 1.0f, 20.0f));
+
+  Ento ball = scene.CreateEntity("Ball");
+  ball.Transform().SetPosition(v3(0.25f, 4.5f, -1.75f));
+  ball.AddComponent<RigidBody>(2.5, 0.3, 0.9);
+  ball.AddComponent<SphereCollider>(v3(0.0f), 0.75);
+
+  Ento box = scene.CreateEntity("Box");
+  box.Transform().SetPosition(v3(3.0f, 2.0f, 1.0f));
+  box.Transform().SetRotation(angleAxis(0.6f, normalize(v3(1.0f, 2.0f, 0.5f))));
+  box.AddComponent<OBBCollider>(v3(0.0f), v3(1.0f, 0.5f, 2.0f), angleAxis(0.3f, v3(0.0f, 1.0f, 0.0f)));
+  RigidBody &trigger = box.AddComponent<RigidBody>(1.0);
+  trigger.is_trigger = true;
+
+  Ento lamp = scene.CreateEntity("Lamp");
+  Light &light = lamp.AddComponent<Light>(LightType::Point, v3(1.0f, 0.5f, 0.25f), 3.0f);
+  light.range = 6.5f;
+
+  Ento bulb = scene.CreateEntity("Bulb");
+  bulb.Transform().SetPosition(v3(0.0f, 0.5f, 0.0f));
+  lamp.AddChild(bulb);
+
+  parent_id = lamp.id;
+  child_id = bulb.id;
+}
+
+i32 main() {
+  Axolotl::Init();
+
+  RoundTripScene source;
+  uuid parent_id;
+  uuid child_id;
+  Populate(source, parent_id, child_id);
+  Snapshot expected = TakeSnapshot(source);
+  Check(!expected.empty(), "Source scene has no registered components");
+
+  // Go through text like the editor does, so number formatting is part of the round trip
+  RoundTripScene from_json;
+  from_json.Deserialize(json::parse(source.Serialize().dump(4)));
+  Compare(expected, TakeSnapshot(from_json), "json");
+  CheckHierarchy(from_json, parent_id, child_id, "json");
+
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "axolotl_scene_roundtrip.axlscene";
+  std::vector<u8> binary = source.SerializeBinary();
+  std::ofstream file(path, std::ios::binary);
+  file.write((const char *)binary.data(), binary.size());
+  file.close();
+
+  RoundTripScene from_binary;
+  Check(from_binary.DeserializeBinary(path), "binary: failed to load");
+  Compare(expected, TakeSnapshot(from_binary), "binary");
+  CheckHierarchy(from_binary, parent_id, child_id, "binary");
+
+  std::filesystem::remove(path);
+  Axolotl::Terminate();
+
+  if (failures)
+    log::error("Scene round trip failed with {} errors", failures);
+  else
+    log::info("Scene round trip passed");
+  return failures ? 1 : 0;
+}